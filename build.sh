@@ -207,7 +207,7 @@ configure_cmake() {
     
     # Platform-specific configuration
     if [[ "$OSTYPE" == "linux-gnu"* ]]; then
-        cmake_args+=(-DCMAKE_CXX_FLAGS="-fPIC -march=native")
+        cmake_args+=(-DCMAKE_CXX_FLAGS="-fPIC")
     elif [[ "$OSTYPE" == "darwin"* ]]; then
         cmake_args+=(-DCMAKE_OSX_DEPLOYMENT_TARGET=10.14)
     fi
@@ -37,6 +37,8 @@
 // Constants based on reverse engineering
 #define MAX_CURVE_POINTS 64
 #define DEFAULT_LUT_SIZE 4096
+#define MAX_LUT3D_SIZE 256     // Nodes per axis of a 3D LUT (the .cube limit)
+#define CURVE_HISTOGRAM_BINS 256
 #define ML_OPERATORS_AVAILABLE 183
 
 extern "C" {
@@ -55,7 +57,9 @@ typedef enum {
     CURVE_ERROR_NOT_INITIALIZED = -3,
     CURVE_ERROR_GPU_NOT_AVAILABLE = -4,
     CURVE_ERROR_ML_NOT_AVAILABLE = -5,
-    CURVE_ERROR_UNSUPPORTED_FORMAT = -6
+    CURVE_ERROR_UNSUPPORTED_FORMAT = -6,
+    CURVE_ERROR_NOT_SUPPORTED = -7,
+    CURVE_ERROR_FILE_IO = -8
 } CurveResult;
 
 /**
@@ -71,16 +75,17 @@ typedef enum {
 
 /**
  * Color channels
+ * Lab channels treat integer samples as sRGB and float samples as linear.
  */
 typedef enum {
     CHANNEL_RGB = 0,
     CHANNEL_RED = 1,
     CHANNEL_GREEN = 2,
     CHANNEL_BLUE = 3,
-    CHANNEL_LUMINANCE = 4,
-    CHANNEL_LAB_L = 5,
-    CHANNEL_LAB_A = 6,
-    CHANNEL_LAB_B = 7
+    CHANNEL_LUMINANCE = 4,    // Scales RGB by curve(luma) / luma, keeping hue
+    CHANNEL_LAB_L = 5,        // CIE Lab (D65) lightness, curve domain L / 100
+    CHANNEL_LAB_A = 6,        // Lab a, curve domain (a + 128) / 255
+    CHANNEL_LAB_B = 7         // Lab b, curve domain (b + 128) / 255
 } ColorChannel;
 
 /**
@@ -95,6 +100,17 @@ typedef enum {
     FORMAT_RGBA32F = 5
 } ImageFormat;
 
+/**
+ * CPU instruction set levels for the pixel kernels
+ */
+typedef enum {
+    CURVE_ISA_AUTO = 0,     // Best level the CPU supports
+    CURVE_ISA_GENERIC = 1,
+    CURVE_ISA_SSE42 = 2,
+    CURVE_ISA_AVX2 = 3,     // AVX2 + FMA
+    CURVE_ISA_AVX512 = 4    // AVX-512 F/BW/DQ/VL
+} CurveIsaLevel;
+
 /**
  * Control point structure
  */
@@ -129,17 +145,69 @@ typedef struct {
     size_t stride;         // Bytes per row
 } ImageData;
 
+/**
+ * Histograms of an image, CURVE_HISTOGRAM_BINS bins each
+ * 8-bit samples are binned by value, 16-bit samples by their high byte
+ * and float samples by value * 256 clamped to [0, 1). luma is Rec.601,
+ * as in luminance mode. Gray images count their one channel everywhere.
+ */
+typedef struct {
+    uint64_t red[CURVE_HISTOGRAM_BINS];
+    uint64_t green[CURVE_HISTOGRAM_BINS];
+    uint64_t blue[CURVE_HISTOGRAM_BINS];
+    uint64_t luma[CURVE_HISTOGRAM_BINS];
+} CurveHistogram;
+
 /**
  * Processing options
  */
 typedef struct {
     bool use_gpu;          // Enable GPU acceleration
     bool use_ai;           // Enable AI-powered features
-    bool real_time;        // Real-time processing mode
+    bool real_time;        // Progressive rendering in curve_preview_update
     int32_t thread_count;  // Number of CPU threads (0 = auto)
     double quality;        // Quality factor [0.0, 1.0]
+    bool in_place;         // Write results into input; output may be NULL
+    CurveHistogram* output_histogram;  // Optional: filled with histograms of the
+                                       // pixels written, in the same pass
 } ProcessingOptions;
 
+/**
+ * Layout of an uncompressed, interleaved raster inside a file
+ */
+typedef struct {
+    ImageFormat format;
+    int32_t width;
+    int32_t height;
+    size_t data_offset;    // Header bytes before the first row (copied unchanged)
+    size_t stride;         // Bytes per row (0 = tightly packed)
+    bool big_endian;       // Samples are stored big-endian (e.g. 16-bit PPM)
+} RasterFileLayout;
+
+/**
+ * Color enhancement settings, as ColorEnhancementModel::enhanceColors takes them
+ */
+typedef struct {
+    float saturation_boost;   // [-1.0, 1.0]
+    float vibrance;           // [-1.0, 1.0]
+    float temperature;        // [-1.0, 1.0], warm positive
+    float tint;               // [-1.0, 1.0]
+} ColorEnhanceParams;
+
+/**
+ * Operations a 3D LUT can be baked from
+ */
+typedef enum {
+    LUT3D_OP_CURVE = 0,             // A curve on its channel (RGB, R/G/B, luminance or Lab)
+    LUT3D_OP_COLOR_ENHANCE = 1      // AI color enhancement
+} Lut3DOpType;
+
+typedef struct {
+    Lut3DOpType type;
+    const CurveData* curve;         // LUT3D_OP_CURVE
+    ColorEnhanceParams enhance;     // LUT3D_OP_COLOR_ENHANCE
+} Lut3DOp;
+
 /**
  * AI suggestion parameters
  */
@@ -186,6 +254,18 @@ CURVE_API bool CURVE_CALL curve_is_ai_available(void);
  */
 CURVE_API int32_t CURVE_CALL curve_get_ml_operator_count(void);
 
+/**
+ * Select the CPU kernel level (the CURVE_FORCE_ISA environment variable
+ * sets the initial choice). Returns CURVE_ERROR_NOT_SUPPORTED if this CPU
+ * or build lacks the requested level.
+ */
+CURVE_API CurveResult CURVE_CALL curve_set_isa_level(CurveIsaLevel level);
+
+/**
+ * Get the CPU kernel level currently in use
+ */
+CURVE_API CurveIsaLevel CURVE_CALL curve_get_isa_level(void);
+
 // =============================================================================
 // Curve Processing Functions
 // =============================================================================
@@ -207,6 +287,10 @@ CURVE_API void CURVE_CALL curve_destroy(CurveData* curve);
 
 /**
  * Apply curve to image data
+ * output may describe the same buffer as input (same data and stride);
+ * partially overlapping buffers are rejected. With options->in_place the
+ * input buffer is updated and output may be NULL, so no second
+ * full-size buffer is needed.
  */
 CURVE_API CurveResult CURVE_CALL curve_apply_to_image(
     const CurveData* curve,
@@ -215,8 +299,32 @@ CURVE_API CurveResult CURVE_CALL curve_apply_to_image(
     const ProcessingOptions* options
 );
 
+/**
+ * Apply curve to a rectangle of the image
+ * input and output describe the full images (same rules as
+ * curve_apply_to_image); only pixels inside [x, x + width) x
+ * [y, y + height) are read or written, so the cost scales with the
+ * rectangle rather than the image.
+ */
+CURVE_API CurveResult CURVE_CALL curve_apply_to_region(
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options
+);
+
 /**
  * Apply multiple curves (multi-channel processing)
+ * RGB curves act as the master curve and RED/GREEN/BLUE curves are
+ * applied on top of it; everything is folded into one table per channel
+ * so the image is traversed once. LUMINANCE curves are folded together
+ * and applied as a luminance pass, then LAB_L/A/B curves (folded per
+ * component) as one Lab pass.
+ * Buffer aliasing and in_place follow curve_apply_to_image.
  */
 CURVE_API CurveResult CURVE_CALL curve_apply_multi_channel(
     const CurveData** curves,
@@ -226,6 +334,21 @@ CURVE_API CurveResult CURVE_CALL curve_apply_multi_channel(
     const ProcessingOptions* options
 );
 
+/**
+ * Compose curves into one: the result maps x to
+ * curves[n-1](...curves[1](curves[0](x)))
+ * All curves must share a channel. The result is a linear curve with one
+ * point per entry of the finest input LUT (well beyond MAX_CURVE_POINTS),
+ * so it bakes back to the composed table and costs the same per pixel as
+ * a single curve. Free it with curve_destroy; curve_generate_lut gives the
+ * table itself.
+ */
+CURVE_API CurveResult CURVE_CALL curve_compose(
+    const CurveData** curves,
+    int32_t curve_count,
+    CurveData** out_curve
+);
+
 /**
  * Generate lookup table from curve
  */
@@ -246,6 +369,258 @@ CURVE_API CurveResult CURVE_CALL curve_apply_lut(
     ColorChannel channel
 );
 
+// =============================================================================
+// Streaming Processing (images larger than memory)
+// =============================================================================
+
+/**
+ * Opaque streaming session
+ */
+typedef struct CurveStream CurveStream;
+
+/**
+ * Start streaming a curve over an image of the given format and width
+ * The curve is baked once here; rows are then pushed in bands of any
+ * height, so peak memory is one band rather than the whole image.
+ */
+CURVE_API CurveResult CURVE_CALL curve_stream_begin(
+    const CurveData* curve,
+    ImageFormat format,
+    int32_t width,
+    const ProcessingOptions* options,
+    CurveStream** out_stream
+);
+
+/**
+ * Process the next band of rows
+ * Channels follow the format (3 for RGB, 4 for RGBA). output_rows may
+ * equal input_rows (with the same stride) to process the band in place.
+ */
+CURVE_API CurveResult CURVE_CALL curve_stream_push_rows(
+    CurveStream* stream,
+    const void* input_rows,
+    size_t input_stride,
+    void* output_rows,
+    size_t output_stride,
+    int32_t row_count
+);
+
+/**
+ * Finish a streaming session and free it
+ */
+CURVE_API void CURVE_CALL curve_stream_end(CurveStream* stream);
+
+// =============================================================================
+// Interactive Editing
+// =============================================================================
+
+/**
+ * Opaque curve editor: a curve whose points move one at a time
+ * An editor is not thread-safe; move points and apply from one thread.
+ */
+typedef struct CurveEditor CurveEditor;
+
+/**
+ * Start editing a copy of curve; its LUT is generated once here
+ */
+CURVE_API CurveResult CURVE_CALL curve_editor_create(
+    const CurveData* curve,
+    CurveEditor** out_editor
+);
+
+/**
+ * Move point index to (x, y) and patch the LUT
+ * y is clamped to [0, 1] and x to the gap between the neighbouring
+ * points. Spline curves re-solve the spline but rewrite only the entries
+ * under segments that moved by more than 1e-6, so a drag costs about the
+ * size of the change; other types regenerate and patch what differs.
+ * out_first/out_count (either may be NULL) receive the rewritten LUT
+ * entries; the count is 0 when the point did not move.
+ */
+CURVE_API CurveResult CURVE_CALL curve_move_point(
+    CurveEditor* editor,
+    int32_t index,
+    double x,
+    double y,
+    int32_t* out_first,
+    int32_t* out_count
+);
+
+/**
+ * Current curve; owned by the editor and updated by every move
+ */
+CURVE_API const CurveData* CURVE_CALL curve_editor_get_curve(const CurveEditor* editor);
+
+/**
+ * Current LUT; owned by the editor and updated in place by every move
+ */
+CURVE_API CurveResult CURVE_CALL curve_editor_get_lut(
+    const CurveEditor* editor,
+    const double** lut,
+    int32_t* lut_size
+);
+
+/**
+ * curve_apply_to_region with the editor's curve
+ * Tables already baked for earlier applies are patched by each move
+ * rather than rebuilt, so dragging a point over a preview rectangle
+ * costs the rectangle plus the changed span.
+ */
+CURVE_API CurveResult CURVE_CALL curve_editor_apply_to_region(
+    const CurveEditor* editor,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options
+);
+
+/**
+ * Free an editor
+ */
+CURVE_API void CURVE_CALL curve_editor_destroy(CurveEditor* editor);
+
+// =============================================================================
+// Progressive Preview
+// =============================================================================
+
+/**
+ * Opaque preview of curve edits on one source image
+ */
+typedef struct CurvePreview CurvePreview;
+
+/**
+ * Receives each rendered preview level
+ * level 0 is full resolution and each level above it halves both sides;
+ * is_final is set for level 0. image belongs to the preview and is only
+ * valid during the call. Refined levels arrive on a worker thread, which
+ * must not block on the thread calling curve_preview_update.
+ */
+typedef void (CURVE_CALL *CurvePreviewCallback)(
+    const ImageData* image,
+    int32_t level,
+    bool is_final,
+    void* user_data
+);
+
+/**
+ * Create a preview of source
+ * source is read, never written, and must stay unchanged until
+ * curve_preview_destroy. Destroy previews before curve_cleanup.
+ */
+CURVE_API CurveResult CURVE_CALL curve_preview_create(
+    const ImageData* source,
+    CurvePreviewCallback callback,
+    void* user_data,
+    CurvePreview** out_preview
+);
+
+/**
+ * Render a curve into the preview, superseding earlier updates
+ * With options->real_time the first update builds a mip pyramid of the
+ * source (kept for later updates); each update then renders the
+ * coarsest level at least as large as the image fitted into the
+ * viewport before returning, and finer levels follow asynchronously,
+ * one callback each, down to full resolution. Without real_time only
+ * full resolution is rendered, before returning.
+ */
+CURVE_API CurveResult CURVE_CALL curve_preview_update(
+    CurvePreview* preview,
+    const CurveData* curve,
+    int32_t viewport_width,
+    int32_t viewport_height,
+    const ProcessingOptions* options
+);
+
+/**
+ * Stop refinement and free the preview; no callback runs afterwards
+ */
+CURVE_API void CURVE_CALL curve_preview_destroy(CurvePreview* preview);
+
+// =============================================================================
+// File Processing
+// =============================================================================
+
+/**
+ * Apply a curve from one raster file to another without staging buffers
+ * Both files are memory-mapped and the kernels run over the mapped
+ * pages. layout may be NULL to detect a binary PPM (P6, 8 or 16 bit);
+ * output_path may name the input file to update it in place.
+ */
+CURVE_API CurveResult CURVE_CALL curve_apply_to_file(
+    const CurveData* curve,
+    const char* input_path,
+    const char* output_path,
+    const RasterFileLayout* layout,
+    const ProcessingOptions* options
+);
+
+// =============================================================================
+// 3D LUTs
+// =============================================================================
+
+/**
+ * Opaque 3D LUT: grid_size^3 RGB nodes over normalized sample values
+ */
+typedef struct CurveLUT3D CurveLUT3D;
+
+/**
+ * Bake a sequence of operations into a 3D LUT
+ * The operations run in order over the grid nodes exactly as they would
+ * on a 16-bit RGB image (integer samples are sRGB for Lab curves); color
+ * enhancement works at 8-bit precision. Typical sizes are 17, 33 and 65;
+ * any size from 2 to MAX_LUT3D_SIZE is accepted. op_count 0 gives the
+ * identity LUT.
+ */
+CURVE_API CurveResult CURVE_CALL curve_lut3d_bake(
+    const Lut3DOp* ops,
+    int32_t op_count,
+    int32_t grid_size,
+    const ProcessingOptions* options,
+    CurveLUT3D** out_lut
+);
+
+/**
+ * Apply a 3D LUT by tetrahedral interpolation
+ * The cost per pixel is fixed, however many operations were baked in.
+ * Images must have 3 or 4 channels (alpha is kept); buffer aliasing and
+ * in_place follow curve_apply_to_image.
+ */
+CURVE_API CurveResult CURVE_CALL curve_apply_3dlut(
+    const CurveLUT3D* lut,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options
+);
+
+/**
+ * Load a 3D LUT from a .cube file (Adobe/Resolve)
+ * Parsed files are cached by path, size and modification time, so loading
+ * the same look again skips the parse. DOMAIN_MIN/DOMAIN_MAX are honored;
+ * files with a 1D table are rejected with CURVE_ERROR_UNSUPPORTED_FORMAT.
+ */
+CURVE_API CurveResult CURVE_CALL curve_lut3d_load_cube(
+    const char* path,
+    CurveLUT3D** out_lut
+);
+
+/**
+ * Write a 3D LUT as a .cube file
+ * @param title Optional TITLE line (may be null)
+ */
+CURVE_API CurveResult CURVE_CALL curve_lut3d_save_cube(
+    const CurveLUT3D* lut,
+    const char* path,
+    const char* title
+);
+
+/**
+ * Free a 3D LUT
+ */
+CURVE_API void CURVE_CALL curve_lut3d_destroy(CurveLUT3D* lut);
+
 // =============================================================================
 // AI-Powered Features (Based on 183 DirectML Operators)
 // DEEP ALGORITHM EXTRACTION from Kumoo7.3.2.exe reverse engineering
@@ -261,8 +636,37 @@ CURVE_API CurveResult CURVE_CALL curve_ai_suggest(
     CurveData** suggested_curve
 );
 
+/**
+ * Statistics of an image
+ * Samples are normalized to [0, 1] (float samples as stored) and luma is
+ * the Rec.601 luma of luminance mode, binned like CurveHistogram::luma.
+ * A pixel is clipped when any of its colour channels is at 0 (shadows)
+ * or full scale (highlights; 1.0 or above for float).
+ */
+typedef struct {
+    uint64_t luma_histogram[CURVE_HISTOGRAM_BINS];
+    uint64_t pixel_count;
+    double luma_mean;
+    double luma_variance;       // Population variance
+    double channel_mean[3];     // Red, green, blue
+    double shadow_clipping;     // Percentage of pixels
+    double highlight_clipping;  // Percentage of pixels
+} CurveImageStats;
+
+/**
+ * Gather image statistics in one parallel pass over the pixels
+ * Gray images (1-2 channels) count channel 0 as R, G and B.
+ */
+CURVE_API CurveResult CURVE_CALL curve_analyze_image(
+    const ImageData* image,
+    CurveImageStats* stats
+);
+
 /**
  * Analyze image and get intelligent recommendations
+ * Derived from curve_analyze_image in the same single pass: contrast is
+ * the luma standard deviation, clipping is in percent and the color cast
+ * is the spread between the largest and smallest channel mean.
  */
 CURVE_API CurveResult CURVE_CALL curve_ai_analyze_image(
     const ImageData* image,
@@ -492,6 +896,97 @@ CURVE_API void CURVE_CALL curve_set_log_callback(LogCallback callback);
  */
 CURVE_API void CURVE_CALL curve_enable_profiling(bool enable);
 
+// =============================================================================
+// Engine Contexts
+// =============================================================================
+
+/**
+ * Opaque engine context
+ * Owns a thread pool, a LUT cache and performance statistics. Calls on
+ * different contexts share none of them, so independent callers (one
+ * per document, say) don't queue behind each other. The functions above
+ * without a context run on a default context created by curve_initialize.
+ */
+typedef struct CurveContext CurveContext;
+
+/**
+ * Create a context working on thread_count threads, the calling thread
+ * included (0 for one per hardware thread)
+ * Requires curve_initialize; destroy every context before curve_cleanup.
+ */
+CURVE_API CurveResult CURVE_CALL curve_context_create(
+    int32_t thread_count,
+    CurveContext** out_context
+);
+
+/**
+ * Destroy a context; streams begun on it must have ended
+ */
+CURVE_API void CURVE_CALL curve_context_destroy(CurveContext* context);
+
+/**
+ * Context forms of the functions of the same name
+ * A context may be used from several threads at once; its calls then
+ * share its workers.
+ */
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_image(
+    CurveContext* context,
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_region(
+    CurveContext* context,
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_multi_channel(
+    CurveContext* context,
+    const CurveData** curves,
+    int32_t curve_count,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_stream_begin(
+    CurveContext* context,
+    const CurveData* curve,
+    ImageFormat format,
+    int32_t width,
+    const ProcessingOptions* options,
+    CurveStream** out_stream
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_file(
+    CurveContext* context,
+    const CurveData* curve,
+    const char* input_path,
+    const char* output_path,
+    const RasterFileLayout* layout,
+    const ProcessingOptions* options
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_analyze_image(
+    CurveContext* context,
+    const ImageData* image,
+    CurveImageStats* stats
+);
+
+CURVE_API CurveResult CURVE_CALL curve_context_get_performance_stats(
+    CurveContext* context,
+    PerformanceStats* stats
+);
+
 } // extern "C"
 
 // =============================================================================
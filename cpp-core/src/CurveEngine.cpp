@@ -7,14 +7,35 @@
 
 #include "AdvancedCurveProcessor.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <vector>
+#include <list>
 #include <map>
 #include <mutex>
+#include <stdexcept>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <unordered_map>
 #include <opencv2/opencv.hpp>
 
+#include "ImageAnalysis.h"
+#include "MipPyramid.h"
+#include "ThreadPool.h"
+#include "ai/ProfessionalAIModels.h"
+#include "io/CubeFile.h"
+#include "io/MappedFile.h"
+#include "io/RasterFile.h"
+#include "kernels/CurveKernels.h"
+#include "kernels/LabTables.h"
+
 #ifdef DIRECTML_ENABLED
 #include "ai/DirectMLProcessor.h"
 #endif
@@ -165,35 +186,150 @@ public:
         
         return lut;
     }
+    
+    /**
+     * Write entries [first, end) of a cubic spline LUT sized lut.size()
+     * Entries outside the span are left alone, so a curve editor can
+     * rewrite just the samples under the segments that changed.
+     */
+    static void writeCubicSplineSpan(
+        const std::vector<CubicSplineInterpolator::SplineSegment>& segments,
+        std::vector<double>& lut, size_t first, size_t end) {
+        int size = lut.size();
+        int last = static_cast<int>(std::min(end, lut.size()));
+        auto sampleX = [size](int i) { return static_cast<double>(i) / (size - 1); };
+        
+        if (segments.empty()) {
+            for (int i = static_cast<int>(first); i < last; ++i) {
+                lut[i] = std::clamp(sampleX(i), 0.0, 1.0);
+            }
+            return;
+        }
+        
+        // Samples are evenly spaced and arrive in x order, so walk the
+        // segments alongside them and step each cubic by forward
+        // differences: three additions per sample instead of a search and
+        // a polynomial. Differences restart at every segment, which keeps
+        // the accumulated rounding far below a 16-bit code.
+        int i = static_cast<int>(first);
+        for (; i < last && sampleX(i) <= segments.front().x_start; ++i) {
+            lut[i] = std::clamp(segments.front().a, 0.0, 1.0);
+        }
+        
+        const double h = sampleX(1);
+        for (const auto& segment : segments) {
+            if (i == last) break;
+            
+            // One past the last sample inside the segment: estimate, then
+            // settle it against the exact sample positions
+            double estimate = std::clamp(segment.x_end * (size - 1) + 1.0, 0.0,
+                                         static_cast<double>(last));
+            int end = std::max(static_cast<int>(estimate), i);
+            while (end < last && sampleX(end) <= segment.x_end) ++end;
+            while (end > i && sampleX(end - 1) > segment.x_end) --end;
+            if (end == i) continue;
+            
+            double t = sampleX(i) - segment.x_start;
+            double value = segment.a + t * (segment.b + t * (segment.c + t * segment.d));
+            double d1 = segment.b * h + segment.c * (2.0 * t * h + h * h) +
+                        segment.d * (3.0 * t * t * h + 3.0 * t * h * h + h * h * h);
+            double d2 = 2.0 * segment.c * h * h + segment.d * (6.0 * t * h * h + 6.0 * h * h * h);
+            double d3 = 6.0 * segment.d * h * h * h;
+            
+            for (; i < end; ++i) {
+                lut[i] = std::clamp(value, 0.0, 1.0);
+                value += d1;
+                d1 += d2;
+                d2 += d3;
+            }
+        }
+        
+        // Right of the last knot the curve holds its end value
+        if (i < last) {
+            double end_value = CubicSplineInterpolator::evaluate(segments, segments.back().x_end);
+            for (; i < last; ++i) {
+                lut[i] = std::clamp(end_value, 0.0, 1.0);
+            }
+        }
+    }
 
 private:
     static void generateLinearLUT(const std::vector<CurvePoint>& points, 
                                   std::vector<double>& lut) {
         int size = lut.size();
+        if (points.size() < 2) {
+            for (int i = 0; i < size; ++i) {
+                lut[i] = linearInterpolate(points, static_cast<double>(i) / (size - 1));
+            }
+            return;
+        }
+        
+        // Samples arrive in x order, so walk the segments alongside them;
+        // dense curves (curve_compose output) would otherwise cost a search
+        // per sample
+        size_t segment = 0;
         for (int i = 0; i < size; ++i) {
             double x = static_cast<double>(i) / (size - 1);
-            lut[i] = linearInterpolate(points, x);
+            if (x <= points.front().x) {
+                lut[i] = points.front().y;
+            } else if (x >= points.back().x) {
+                lut[i] = points.back().y;
+            } else {
+                while (x > points[segment + 1].x) ++segment;
+                const CurvePoint& a = points[segment];
+                const CurvePoint& b = points[segment + 1];
+                double t = (x - a.x) / (b.x - a.x);
+                lut[i] = a.y + t * (b.y - a.y);
+            }
         }
     }
     
     static void generateCubicSplineLUT(const std::vector<CurvePoint>& points,
                                        std::vector<double>& lut) {
         auto segments = CubicSplineInterpolator::calculateSplineSegments(points);
-        int size = lut.size();
-        
-        for (int i = 0; i < size; ++i) {
-            double x = static_cast<double>(i) / (size - 1);
-            lut[i] = std::clamp(CubicSplineInterpolator::evaluate(segments, x), 0.0, 1.0);
-        }
+        writeCubicSplineSpan(segments, lut, 0, lut.size());
     }
     
+    /**
+     * One Bezier curve through all control points, sampled at x rather
+     * than at the curve parameter. Control points are sorted by x, so x(t)
+     * never decreases and each sample's t lies at or after the previous
+     * sample's.
+     */
     static void generateBezierLUT(const std::vector<CurvePoint>& points,
                                   std::vector<double>& lut) {
-        // Bezier curve implementation
         int size = lut.size();
+        if (points.size() < 2) {
+            for (int i = 0; i < size; ++i) {
+                double x = static_cast<double>(i) / (size - 1);
+                lut[i] = std::clamp(points.empty() ? x : points[0].y, 0.0, 1.0);
+            }
+            return;
+        }
+        if (points.size() > MAX_CURVE_POINTS) {
+            // Beyond the documented point limit the coefficient storage
+            // (and double-precision binomials) run out; follow the polygon
+            generateLinearLUT(points, lut);
+            return;
+        }
+        
+        BezierPolynomial curve(points);
+        const CurvePoint& first = points.front();
+        const CurvePoint& last = points.back();
+        BezierPolynomial::Position position = curve.positionAt(0.0);
+        
         for (int i = 0; i < size; ++i) {
-            double t = static_cast<double>(i) / (size - 1);
-            lut[i] = evaluateBezier(points, t);
+            double x = static_cast<double>(i) / (size - 1);
+            double y;
+            if (x <= first.x) {
+                y = first.y;
+            } else if (x >= last.x) {
+                y = last.y;
+            } else {
+                curve.solve(x, &position);
+                y = curve.y(position.t);
+            }
+            lut[i] = std::clamp(y, 0.0, 1.0);
         }
     }
     
@@ -243,252 +379,1996 @@ private:
         return x; // Fallback
     }
     
-    static double evaluateBezier(const std::vector<CurvePoint>& points, double t) {
-        // De Casteljau's algorithm for Bezier curves
-        if (points.empty()) return t;
+    /**
+     * Bezier curve in Bernstein form on fixed storage
+     * Coefficients are pre-scaled by their binomials, so evaluation is a
+     * single Horner-style pass with no allocation.
+     */
+    class BezierPolynomial {
+    public:
+        /**
+         * Parameter with the curve's x and its first two derivatives there
+         */
+        struct Position {
+            double t;
+            double x;
+            double slope;
+            double curvature;
+        };
+        
+        explicit BezierPolynomial(const std::vector<CurvePoint>& points)
+            : degree_(static_cast<int>(points.size()) - 1) {
+            // Derivatives of a Bezier are Bezier curves on the control
+            // point differences, one degree lower each
+            double binomial = 1.0;
+            double slope_binomial = 1.0;
+            double curvature_binomial = 1.0;
+            ddx_[0] = 0.0;
+            for (int i = 0; i <= degree_; ++i) {
+                x_[i] = points[i].x * binomial;
+                y_[i] = points[i].y * binomial;
+                binomial = binomial * (degree_ - i) / (i + 1);
+                if (i < degree_) {
+                    dx_[i] = degree_ * (points[i + 1].x - points[i].x) * slope_binomial;
+                    slope_binomial = slope_binomial * (degree_ - 1 - i) / (i + 1);
+                }
+                if (i < degree_ - 1) {
+                    ddx_[i] = degree_ * (degree_ - 1) *
+                              (points[i + 2].x - 2.0 * points[i + 1].x + points[i].x) *
+                              curvature_binomial;
+                    curvature_binomial = curvature_binomial * (degree_ - 2 - i) / (i + 1);
+                }
+            }
+        }
         
-        std::vector<CurvePoint> temp = points;
-        int n = temp.size();
+        double y(double t) const {
+            double s = 1.0 - t;
+            double t_power = 1.0;
+            double sum = y_[0];
+            for (int i = 1; i <= degree_; ++i) {
+                t_power *= t;
+                sum = sum * s + y_[i] * t_power;
+            }
+            return sum;
+        }
         
-        for (int i = 1; i < n; ++i) {
-            for (int j = 0; j < n - i; ++j) {
-                temp[j].x = (1 - t) * temp[j].x + t * temp[j + 1].x;
-                temp[j].y = (1 - t) * temp[j].y + t * temp[j + 1].y;
+        /**
+         * x(t) and its derivatives in one pass
+         * Horner in (1 - t) over the coefficients times powers of t, so
+         * both bases stay in [0, 1] and nothing divides.
+         */
+        Position positionAt(double t) const {
+            double s = 1.0 - t;
+            double t_power = 1.0;
+            double sum = x_[0];
+            double slope_sum = dx_[0];
+            double curvature_sum = ddx_[0];
+            for (int i = 1; i <= degree_; ++i) {
+                t_power *= t;
+                sum = sum * s + x_[i] * t_power;
+                if (i < degree_) slope_sum = slope_sum * s + dx_[i] * t_power;
+                if (i < degree_ - 1) curvature_sum = curvature_sum * s + ddx_[i] * t_power;
             }
+            return {t, sum, slope_sum, curvature_sum};
         }
         
-        return std::clamp(temp[0].y, 0.0, 1.0);
-    }
+        /**
+         * Advance position to where the curve reaches x, for x at or past
+         * position->x
+         * Steps from the previous sample's solution with the curvature
+         * term added to Newton's (Chebyshev's method, cubic convergence),
+         * so neighbouring LUT samples usually need a single evaluation. A
+         * step that leaves the bracket, or a flat spot in x, falls back to
+         * bisection.
+         */
+        void solve(double x, Position* position) const {
+            constexpr double tolerance = 1e-10;   // In x, far below a 16-bit code
+            constexpr int max_iterations = 64;
+            
+            double lo = position->t;
+            double hi = 1.0;
+            for (int iteration = 0; iteration < max_iterations && hi - lo > tolerance;
+                 ++iteration) {
+                double error = position->x - x;
+                if (std::abs(error) <= tolerance) break;
+                if (error < 0.0) {
+                    lo = position->t;
+                } else {
+                    hi = position->t;
+                }
+                
+                double next = lo;
+                if (position->slope > 0.0) {
+                    double inverse_slope = 1.0 / position->slope;
+                    double step = -error * inverse_slope;
+                    next = position->t + step -
+                           0.5 * position->curvature * inverse_slope * step * step;
+                }
+                *position = positionAt((next > lo && next < hi) ? next : 0.5 * (lo + hi));
+            }
+        }
+        
+    private:
+        int degree_;
+        double x_[MAX_CURVE_POINTS];
+        double y_[MAX_CURVE_POINTS];
+        double dx_[MAX_CURVE_POINTS];
+        double ddx_[MAX_CURVE_POINTS];
+    };
 };
 
 /**
- * Performance-optimized image processor
- * Uses SIMD and multi-threading based on reverse engineering insights
+ * Curve LUT baked once and shared between apply calls
+ * Format-specific tables are derived lazily the first time a kernel
+ * needs them, so a cached curve pays for each table at most once. Each
+ * table is sized by the format it serves (256 x u8, 65536 x u16, float
+ * for float images); the double-precision master is only generated for
+ * the paths that interpolate it.
  */
-class ImageCurveProcessor {
+class BakedCurveLUT {
 public:
-    static void applyLUTToImage(const std::vector<double>& lut,
-                               const ImageData& input,
-                               ImageData& output,
-                               ColorChannel channel,
-                               const ProcessingOptions& options) {
+    explicit BakedCurveLUT(std::vector<double> lut) : lut_(std::move(lut)) {
+        std::call_once(lut_once_, [] {});
+    }
+    
+    /**
+     * Curve source, the master LUT is generated on first use
+     */
+    BakedCurveLUT(std::vector<CurvePoint> points, CurveType type, int32_t lut_size)
+        : points_(std::move(points)), type_(type), lut_size_(lut_size) {}
+    
+    const std::vector<double>& lut() const {
+        std::call_once(lut_once_, [this] {
+            lut_ = LookupTableGenerator::generateOptimizedLUT(points_, type_, lut_size_);
+        });
+        return lut_;
+    }
+    
+    const uint8_t* table8() const {
+        std::call_once(table8_once_, [this] {
+            bakeIntegerTable(table8_);
+            table8_baked_ = true;
+        });
+        return table8_;
+    }
+    
+    const uint16_t* table16() const {
+        std::call_once(table16_once_, [this] {
+            table16_.resize(65536);
+            bakeIntegerTable(table16_.data());
+            table16_baked_ = true;
+        });
+        return table16_.data();
+    }
+    
+    /**
+     * 16-bit table for byte-swapped samples (big-endian files on a
+     * little-endian host): indexed and filled with swapped codes
+     */
+    const uint16_t* table16Swapped() const {
+        std::call_once(table16_swapped_once_, [this] {
+            const uint16_t* table = table16();
+            table16_swapped_.resize(65536);
+            for (uint32_t value = 0; value < 65536; ++value) {
+                table16_swapped_[swapBytes(static_cast<uint16_t>(value))] = swapBytes(table[value]);
+            }
+            table16_swapped_baked_ = true;
+        });
+        return table16_swapped_.data();
+    }
+    
+    /**
+     * Luminance-mode gain tables, see Kernels::LumaTables8/16
+     */
+    Kernels::LumaTables8 lumaTables8() const {
+        std::call_once(luma8_once_, [this] {
+            const std::vector<double>& master = lut();
+            luma8_gain_[0] = 0;
+            bakeLumaGains8(master, 1, 256);
+            luma8_baked_ = true;
+        });
+        auto black = static_cast<int32_t>(
+            std::clamp(sampleLUT(lut(), 0.0) * 255.0 + 0.5, 0.0, 255.0));
+        return {luma8_gain_, lumaLimit8(), black};
+    }
+    
+    Kernels::LumaTables16 lumaTables16() const {
+        std::call_once(luma16_once_, [this] {
+            luma16_gain_.resize(65536);
+            const std::vector<double>& master = lut();
+            luma16_gain_[0] = 0.0f;
+            bakeLumaGains16(master, 1, 65536);
+            luma16_baked_ = true;
+        });
+        float black = static_cast<float>(std::clamp(sampleLUT(lut(), 0.0), 0.0, 1.0) * 65535.0);
+        return {luma16_gain_.data(), black};
+    }
+    
+    const std::vector<float>& tableFloat() const {
+        std::call_once(table_float_once_, [this] {
+            const std::vector<double>& master = lut();
+            table_float_.assign(master.begin(), master.end());
+            if (table_float_.size() < 2) {
+                table_float_.resize(2, table_float_.empty() ? 0.0f : table_float_[0]);
+            }
+            table_float_baked_ = true;
+        });
+        return table_float_;
+    }
+    
+    /**
+     * Bake outer(inner(x)) at the finer of the two LUT resolutions
+     */
+    static std::shared_ptr<const BakedCurveLUT> compose(const BakedCurveLUT& inner,
+                                                        const BakedCurveLUT& outer) {
+        const std::vector<double>& inner_lut = inner.lut();
+        const std::vector<double>& outer_lut = outer.lut();
+        size_t size = std::max(inner_lut.size(), outer_lut.size());
+        std::vector<double> lut(size);
         
-        if (options.use_gpu && isGPUAvailable()) {
-            applyLUTGPU(lut, input, output, channel, options);
-            return;
+        for (size_t i = 0; i < size; ++i) {
+            double x = static_cast<double>(i) / (size - 1);
+            lut[i] = sampleLUT(outer_lut, std::clamp(sampleLUT(inner_lut, x), 0.0, 1.0));
         }
         
-        // CPU implementation with SIMD optimization
-        applyLUTCPU(lut, input, output, channel, options);
+        return std::make_shared<const BakedCurveLUT>(std::move(lut));
     }
-
-private:
-    static void applyLUTCPU(const std::vector<double>& lut,
-                           const ImageData& input,
-                           ImageData& output,
-                           ColorChannel channel,
-                           const ProcessingOptions& options) {
+    
+    /**
+     * What a Lab L curve does to a neutral pixel, as a curve on the sample
+     * value: gray has a = b = 0 and Y equal to the linear value
+     * @param linear Samples are linear light (float) rather than sRGB codes
+     */
+    static std::shared_ptr<const BakedCurveLUT> grayLightness(const BakedCurveLUT& curve,
+                                                              bool linear) {
+        constexpr size_t size = 4096;
+        const std::vector<double>& curve_lut = curve.lut();
+        std::vector<double> lut(size);
         
-        int width = input.width;
-        int height = input.height;
-        int channels = input.channels;
+        for (size_t i = 0; i < size; ++i) {
+            double value = static_cast<double>(i) / (size - 1);
+            double y = linear ? value : Kernels::srgbToLinear(value);
+            double lightness = 1.16 * Kernels::labF(y) - 0.16;
+            double mapped = std::clamp(sampleLUT(curve_lut, std::clamp(lightness, 0.0, 1.0)),
+                                       0.0, 1.0);
+            y = Kernels::labFInverse((100.0 * mapped + 16.0) / 116.0);
+            lut[i] = linear ? y : Kernels::linearToSrgb(y);
+        }
+        
+        return std::make_shared<const BakedCurveLUT>(std::move(lut));
+    }
+    
+    /**
+     * Interpolated LUT lookup for a normalized input value
+     */
+    static double sampleLUT(const std::vector<double>& lut, double normalized) {
         size_t lut_size = lut.size();
-        double lut_scale = lut_size - 1;
-        
-        // Determine number of threads
-        int thread_count = options.thread_count > 0 ? 
-                          options.thread_count : 
-                          std::thread::hardware_concurrency();
-        
-        // Process image in parallel strips
-        #pragma omp parallel for num_threads(thread_count)
-        for (int y = 0; y < height; ++y) {
-            const uint8_t* src_row = static_cast<const uint8_t*>(input.data) + 
-                                    y * input.stride;
-            uint8_t* dst_row = static_cast<uint8_t*>(output.data) + 
-                              y * output.stride;
-            
-            for (int x = 0; x < width; ++x) {
-                int pixel_offset = x * channels;
-                
-                if (channel == CHANNEL_RGB || channel == CHANNEL_LUMINANCE) {
-                    // Apply to all channels
-                    for (int c = 0; c < std::min(3, channels); ++c) {
-                        uint8_t value = src_row[pixel_offset + c];
-                        double normalized = value / 255.0;
-                        
-                        // Fast LUT lookup with interpolation
-                        double lut_pos = normalized * lut_scale;
-                        int lut_index = static_cast<int>(lut_pos);
-                        double frac = lut_pos - lut_index;
-                        
-                        double result;
-                        if (lut_index >= static_cast<int>(lut_size) - 1) {
-                            result = lut[lut_size - 1];
-                        } else {
-                            result = lut[lut_index] + frac * (lut[lut_index + 1] - lut[lut_index]);
-                        }
-                        
-                        dst_row[pixel_offset + c] = static_cast<uint8_t>(
-                            std::clamp(result * 255.0 + 0.5, 0.0, 255.0));
-                    }
-                } else {
-                    // Apply to specific channel
-                    int channel_index = getChannelIndex(channel);
-                    if (channel_index >= 0 && channel_index < channels) {
-                        uint8_t value = src_row[pixel_offset + channel_index];
-                        double normalized = value / 255.0;
-                        
-                        double lut_pos = normalized * lut_scale;
-                        int lut_index = static_cast<int>(lut_pos);
-                        double frac = lut_pos - lut_index;
-                        
-                        double result;
-                        if (lut_index >= static_cast<int>(lut_size) - 1) {
-                            result = lut[lut_size - 1];
-                        } else {
-                            result = lut[lut_index] + frac * (lut[lut_index + 1] - lut[lut_index]);
-                        }
-                        
-                        dst_row[pixel_offset + channel_index] = static_cast<uint8_t>(
-                            std::clamp(result * 255.0 + 0.5, 0.0, 255.0));
-                        
-                        // Copy other channels unchanged
-                        for (int c = 0; c < channels; ++c) {
-                            if (c != channel_index) {
-                                dst_row[pixel_offset + c] = src_row[pixel_offset + c];
-                            }
-                        }
-                    }
-                }
-                
-                // Copy alpha channel if present
-                if (channels == 4) {
-                    dst_row[pixel_offset + 3] = src_row[pixel_offset + 3];
+        double lut_pos = normalized * (lut_size - 1);
+        int lut_index = static_cast<int>(lut_pos);
+        double frac = lut_pos - lut_index;
+        
+        if (lut_index >= static_cast<int>(lut_size) - 1) {
+            return lut[lut_size - 1];
+        }
+        return lut[lut_index] + frac * (lut[lut_index + 1] - lut[lut_index]);
+    }
+    
+    /**
+     * Rewrite master entries [first, end) in place after the curve source
+     * changed to points
+     * write(lut, first, end) fills a span of a LUT of any size, sample i
+     * lying at i / (size - 1); every table built so far then re-bakes only
+     * the codes that read the span, so the cost follows the span rather
+     * than the table sizes. Tables sampled at their codes (see
+     * bakeIntegerTable) are re-sampled through write as well. The caller
+     * must own this LUT exclusively (see IncrementalCurveLUT): nothing may
+     * be reading it meanwhile.
+     */
+    template <typename Writer>
+    void rewriteSpan(const std::vector<CurvePoint>& points, size_t first, size_t end,
+                     Writer&& write) {
+        lut();
+        points_ = points;
+        std::vector<double>& master = lut_;
+        end = std::min(end, master.size());
+        if (first >= end) return;
+        write(master, first, end);
+        
+        if (table8_baked_) {
+            rewriteCodes(table8_, first, end, write);
+        }
+        if (table16_baked_) {
+            auto [lo, hi] = rewriteCodes(table16_.data(), first, end, write);
+            if (table16_swapped_baked_) {
+                for (int value = lo; value < hi; ++value) {
+                    table16_swapped_[swapBytes(static_cast<uint16_t>(value))] =
+                        swapBytes(table16_[value]);
                 }
             }
         }
+        if (luma8_baked_) {
+            auto [lo, hi] = codeSpan(master.size(), first, end, 255);
+            bakeLumaGains8(master, std::max(lo, 1), hi);
+        }
+        if (luma16_baked_) {
+            auto [lo, hi] = codeSpan(master.size(), first, end, 65535);
+            bakeLumaGains16(master, std::max(lo, 1), hi);
+        }
+        if (table_float_baked_ && master.size() >= 2) {
+            std::copy(master.begin() + first, master.begin() + end, table_float_.begin() + first);
+        }
+    }
+
+private:
+    /**
+     * Curve-independent cap: the largest Q12 gain that keeps a channel of
+     * the given value at or below 255
+     */
+    static const int32_t* lumaLimit8() {
+        static const auto limits = [] {
+            std::array<int32_t, 256> table;
+            table[0] = std::numeric_limits<int32_t>::max();
+            for (int value = 1; value < 256; ++value) {
+                table[value] = (255 << Kernels::LUMA8_GAIN_BITS) / value;
+            }
+            return table;
+        }();
+        return limits.data();
     }
     
-    static void applyLUTGPU(const std::vector<double>& lut,
-                           const ImageData& input,
-                           ImageData& output,
-                           ColorChannel channel,
-                           const ProcessingOptions& options) {
-        #ifdef OPENCL_ENABLED
-        // OpenCL implementation
-        // TODO: Implement GPU processing
-        #endif
-        
-        #ifdef DIRECTML_ENABLED
-        // DirectML implementation using discovered operators
-        // TODO: Implement DirectML processing
-        #endif
+    static uint16_t swapBytes(uint16_t value) {
+        return static_cast<uint16_t>((value << 8) | (value >> 8));
+    }
+    
+    /**
+     * Bake a table covering every possible integer sample value
+     * When the curve's LUT resolution is at least the number of codes,
+     * the curve is sampled at the codes themselves (256 points for 8-bit
+     * rather than a 4096-point master); otherwise the master is
+     * interpolated so a coarse lut_size still shows in the result.
+     */
+    template <typename T>
+    void bakeIntegerTable(T* table) const {
+        constexpr int max_value = std::numeric_limits<T>::max();
+        if (lut_size_ > max_value) {
+            std::vector<double> samples =
+                LookupTableGenerator::generateOptimizedLUT(points_, type_, max_value + 1);
+            for (int value = 0; value <= max_value; ++value) {
+                table[value] = quantize<T>(samples[value]);
+            }
+            return;
+        }
         
-        // Fallback to CPU
-        applyLUTCPU(lut, input, output, channel, options);
+        bakeCodes(lut(), table, 0, max_value + 1);
     }
     
-    static bool isGPUAvailable() {
-        #if defined(OPENCL_ENABLED) || defined(DIRECTML_ENABLED)
-        return true;
-        #else
-        return false;
-        #endif
+    /**
+     * Re-bake the codes of a baked integer table that read master entries
+     * [first, end), the way bakeIntegerTable built it
+     * @return The codes rewritten
+     */
+    template <typename T, typename Writer>
+    std::pair<int, int> rewriteCodes(T* table, size_t first, size_t end, Writer& write) {
+        constexpr int max_value = std::numeric_limits<T>::max();
+        auto [lo, hi] = codeSpan(lut_.size(), first, end, max_value);
+        if (lut_size_ > max_value) {
+            std::vector<double> samples(max_value + 1);
+            write(samples, lo, hi);
+            for (int value = lo; value < hi; ++value) {
+                table[value] = quantize<T>(samples[value]);
+            }
+        } else {
+            bakeCodes(lut_, table, lo, hi);
+        }
+        return {lo, hi};
     }
     
-    static int getChannelIndex(ColorChannel channel) {
-        switch (channel) {
-            case CHANNEL_RED: return 0;
-            case CHANNEL_GREEN: return 1;
-            case CHANNEL_BLUE: return 2;
-            default: return -1;
+    /**
+     * Bake codes [first, end) of an integer table from the master
+     */
+    template <typename T>
+    static void bakeCodes(const std::vector<double>& master, T* table, int first, int end) {
+        constexpr int max_value = std::numeric_limits<T>::max();
+        for (int value = first; value < end; ++value) {
+            table[value] = quantize<T>(sampleLUT(master, static_cast<double>(value) / max_value));
+        }
+    }
+    
+    /**
+     * Normalized curve output to the nearest integer code
+     */
+    template <typename T>
+    static T quantize(double result) {
+        constexpr int max_value = std::numeric_limits<T>::max();
+        return static_cast<T>(
+            std::clamp(result * max_value + 0.5, 0.0, static_cast<double>(max_value)));
+    }
+    
+    /**
+     * Codes of a 0..max_value table whose lookups read master entries
+     * [first, end): code v interpolates entries floor(v * (n - 1) / max)
+     * and the one after it. Padded by a code each way for rounding.
+     */
+    static std::pair<int, int> codeSpan(size_t lut_size, size_t first, size_t end,
+                                        int max_value) {
+        double scale = static_cast<double>(max_value) / (lut_size - 1);
+        double lo = std::floor((static_cast<double>(first) - 1.0) * scale) - 1.0;
+        double hi = std::ceil(static_cast<double>(end) * scale) + 2.0;
+        return {static_cast<int>(std::max(lo, 0.0)),
+                static_cast<int>(std::min(hi, max_value + 1.0))};
+    }
+    
+    void bakeLumaGains8(const std::vector<double>& master, int first, int end) const {
+        constexpr double one = 1 << Kernels::LUMA8_GAIN_BITS;
+        for (int luma = first; luma < end; ++luma) {
+            double mapped = sampleLUT(master, luma / 255.0) * 255.0;
+            luma8_gain_[luma] = static_cast<int32_t>(std::max(mapped, 0.0) / luma * one + 0.5);
+        }
+    }
+    
+    void bakeLumaGains16(const std::vector<double>& master, int first, int end) const {
+        for (int luma = first; luma < end; ++luma) {
+            double mapped = sampleLUT(master, luma / 65535.0) * 65535.0;
+            luma16_gain_[luma] = static_cast<float>(std::max(mapped, 0.0) / luma);
         }
     }
+    
+    // Curve source; lut_size_ stays 0 for LUTs built from a ready master
+    std::vector<CurvePoint> points_;
+    CurveType type_ = CURVE_TYPE_LINEAR;
+    int32_t lut_size_ = 0;
+    
+    mutable std::once_flag lut_once_;
+    mutable std::vector<double> lut_;
+    
+    mutable std::once_flag table8_once_;
+    mutable uint8_t table8_[256] = {};
+    mutable std::once_flag table16_once_;
+    mutable std::vector<uint16_t> table16_;
+    mutable std::once_flag table16_swapped_once_;
+    mutable std::vector<uint16_t> table16_swapped_;
+    mutable std::once_flag luma8_once_;
+    mutable int32_t luma8_gain_[256] = {};
+    mutable std::once_flag luma16_once_;
+    mutable std::vector<float> luma16_gain_;
+    mutable std::once_flag table_float_once_;
+    mutable std::vector<float> table_float_;
+    
+    // Which tables exist for rewriteSpan to patch; each is set inside its
+    // call_once, so it is visible to anyone the table was handed to
+    mutable bool table8_baked_ = false;
+    mutable bool table16_baked_ = false;
+    mutable bool table16_swapped_baked_ = false;
+    mutable bool luma8_baked_ = false;
+    mutable bool luma16_baked_ = false;
+    mutable bool table_float_baked_ = false;
 };
 
-} // namespace PhotoStudioPro
-
-// =============================================================================
-// Global State Management
-// =============================================================================
-
-namespace {
-    bool g_initialized = false;
-    std::mutex g_state_mutex;
-    PhotoStudioPro::PerformanceStats g_perf_stats = {};
-    std::chrono::high_resolution_clock::time_point g_last_operation_time;
+/**
+ * Master LUT of a curve whose points move one at a time (CurveEditor)
+ * Moving a spline knot re-solves the whole spline, but the natural
+ * spline's response falls off by roughly 3.7x per segment away from the
+ * knot, so only segments whose cubic moved by more than SPAN_TOLERANCE
+ * are rewritten; the rest keep the samples they already have. Other
+ * curve types regenerate the LUT and patch the span that differs.
+ */
+class IncrementalCurveLUT {
+public:
+    // Largest drift a skipped segment may carry, well under a 16-bit code
+    static constexpr double SPAN_TOLERANCE = 1e-6;
     
-    #ifdef DIRECTML_ENABLED
-    std::unique_ptr<DirectMLProcessor> g_directml_processor;
-    #endif
+    // Closest a moved point may come to its neighbours in x
+    static constexpr double MIN_POINT_GAP = 1.0 / 65535.0;
     
-    #ifdef OPENCL_ENABLED
-    std::unique_ptr<OpenCLProcessor> g_opencl_processor;
-    #endif
-}
-
-// =============================================================================
-// C API Implementation
-// =============================================================================
-
-extern "C" {
-
-CURVE_API CurveResult CURVE_CALL curve_initialize(void) {
-    std::lock_guard<std::mutex> lock(g_state_mutex);
+    IncrementalCurveLUT(std::vector<CurvePoint> points, CurveType type, int32_t lut_size)
+        : points_(std::move(points)), type_(type),
+          baked_(std::make_shared<BakedCurveLUT>(points_, type_, lut_size)) {
+        if (type_ == CURVE_TYPE_CUBIC_SPLINE) {
+            segments_ = CubicSplineInterpolator::calculateSplineSegments(points_);
+        }
+    }
     
-    if (g_initialized) {
-        return CURVE_SUCCESS;
+    /**
+     * Move a point and patch the LUT
+     * y is clamped to [0, 1] and x to the gap between the neighbouring
+     * points, so the points stay in order.
+     * @return Rewritten entries [first, end); empty when nothing changed
+     */
+    std::pair<size_t, size_t> movePoint(size_t index, double x, double y) {
+        CurvePoint& point = points_[index];
+        double lo = index > 0 ? points_[index - 1].x + MIN_POINT_GAP : 0.0;
+        double hi = index + 1 < points_.size() ? points_[index + 1].x - MIN_POINT_GAP : 1.0;
+        x = lo <= hi ? std::clamp(x, lo, hi) : point.x;
+        y = std::clamp(y, 0.0, 1.0);
+        if (x == point.x && y == point.y) {
+            return {0, 0};
+        }
+        
+        point.x = x;
+        point.y = y;
+        return type_ == CURVE_TYPE_CUBIC_SPLINE ? patchSpline(index) : patchRegenerated();
     }
     
-    try {
-        // Initialize performance tracking
-        g_perf_stats = {};
-        g_last_operation_time = std::chrono::high_resolution_clock::now();
+    const std::vector<CurvePoint>& points() const { return points_; }
+    
+    const std::vector<double>& lut() const { return baked_->lut(); }
+    
+    /**
+     * Tables for the apply path; they follow later moves in place and
+     * are baked from the curve the way curve_apply_to_region bakes them
+     */
+    std::shared_ptr<const BakedCurveLUT> baked() const { return baked_; }
+
+private:
+    std::pair<size_t, size_t> patchSpline(size_t index) {
+        auto segments = CubicSplineInterpolator::calculateSplineSegments(points_);
         
-        #ifdef DIRECTML_ENABLED
-        g_directml_processor = std::make_unique<DirectMLProcessor>();
-        if (!g_directml_processor->initialize()) {
-            // DirectML not available, continue without AI features
-            g_directml_processor.reset();
+        // The segments meeting at the knot changed extent as well as shape;
+        // elsewhere compare against the cubics the LUT was written from
+        size_t first_dirty = index > 0 ? index - 1 : 0;
+        size_t last_dirty = std::min(index, segments.size() - 1);
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (segmentChange(segments_[s], segments[s]) > SPAN_TOLERANCE) {
+                first_dirty = std::min(first_dirty, s);
+                last_dirty = std::max(last_dirty, s);
+            }
         }
-        #endif
         
-        #ifdef OPENCL_ENABLED
-        g_opencl_processor = std::make_unique<OpenCLProcessor>();
-        if (!g_opencl_processor->initialize()) {
-            // OpenCL not available, continue without GPU acceleration
-            g_opencl_processor.reset();
+        // Sample i lies at i / (n - 1); the end segments also own the flat
+        // regions beyond the outer knots
+        size_t size = lut().size();
+        double scale = static_cast<double>(size - 1);
+        size_t first = 0;
+        size_t end = size;
+        if (first_dirty > 0) {
+            first = static_cast<size_t>(segments[first_dirty].x_start * scale);
+        }
+        if (last_dirty + 1 < segments.size()) {
+            end = std::min(size, static_cast<size_t>(segments[last_dirty].x_end * scale) + 2);
         }
-        #endif
         
-        g_initialized = true;
-        return CURVE_SUCCESS;
+        baked_->rewriteSpan(points_, first, end,
+                            [&segments](std::vector<double>& lut, size_t f, size_t e) {
+            LookupTableGenerator::writeCubicSplineSpan(segments, lut, f, e);
+        });
+        std::copy(segments.begin() + first_dirty, segments.begin() + last_dirty + 1,
+                  segments_.begin() + first_dirty);
+        return {first, end};
+    }
+    
+    std::pair<size_t, size_t> patchRegenerated() {
+        const std::vector<double>& current = lut();
+        scratch_ = LookupTableGenerator::generateOptimizedLUT(points_, type_,
+                                                             static_cast<int>(current.size()));
         
-    } catch (const std::exception&) {
-        return CURVE_ERROR_NOT_INITIALIZED;
+        size_t first = 0;
+        size_t end = current.size();
+        while (first < end && current[first] == scratch_[first]) ++first;
+        while (end > first && current[end - 1] == scratch_[end - 1]) --end;
+        if (first == end) {
+            return {0, 0};
+        }
+        
+        baked_->rewriteSpan(points_, first, end,
+                            [this](std::vector<double>& lut, size_t f, size_t e) {
+            // Code-sampled tables ask for a span at their own resolution
+            if (lut.size() != scratch_.size()) {
+                std::vector<double> codes = LookupTableGenerator::generateOptimizedLUT(
+                    points_, type_, static_cast<int>(lut.size()));
+                std::copy(codes.begin() + f, codes.begin() + e, lut.begin() + f);
+                return;
+            }
+            std::copy(scratch_.begin() + f, scratch_.begin() + e, lut.begin() + f);
+        });
+        return {first, end};
     }
-}
-
-CURVE_API void CURVE_CALL curve_cleanup(void) {
-    std::lock_guard<std::mutex> lock(g_state_mutex);
     
-    if (!g_initialized) return;
+    /**
+     * Bound on |new(x) - old(x)| over a segment with unchanged extent
+     */
+    static double segmentChange(const CubicSplineInterpolator::SplineSegment& before,
+                                const CubicSplineInterpolator::SplineSegment& after) {
+        double h = before.x_end - before.x_start;
+        return std::abs(after.a - before.a) +
+               h * (std::abs(after.b - before.b) +
+                    h * (std::abs(after.c - before.c) + h * std::abs(after.d - before.d)));
+    }
     
-    #ifdef DIRECTML_ENABLED
-    g_directml_processor.reset();
-    #endif
+    std::vector<CurvePoint> points_;
+    CurveType type_;
+    std::vector<CubicSplineInterpolator::SplineSegment> segments_;   // As written to the LUT
+    std::shared_ptr<BakedCurveLUT> baked_;
+    std::vector<double> scratch_;
+};
+
+/**
+ * LRU cache of baked curve LUTs
+ * Keyed by the content of the curve (points, type, LUT size, channel) so
+ * the same preset applied across a batch generates its LUT only once.
+ */
+class CurveLUTCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
     
-    #ifdef OPENCL_ENABLED
-    g_opencl_processor.reset();
-    #endif
+    explicit CurveLUTCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
     
-    g_initialized = false;
-}
-
-CURVE_API const char* CURVE_CALL curve_get_version(void) {
-    return "1.0.0-rev183ops";  // Version includes reference to 183 operators
-}
+    std::shared_ptr<const BakedCurveLUT> acquire(const CurveData& curve, bool* hit) {
+        Key key = makeKey(curve);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto range = index_.equal_range(key.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second->key == key) {
+                    entries_.splice(entries_.begin(), entries_, it->second);
+                    if (hit) *hit = true;
+                    return it->second->baked;
+                }
+            }
+        }
+        
+        // Tables are generated on first use, outside the lock, so concurrent
+        // misses don't serialize
+        auto baked = std::make_shared<const BakedCurveLUT>(key.points, key.type, key.lut_size);
+        if (hit) *hit = false;
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_front({key, baked});
+        index_.emplace(key.hash, entries_.begin());
+        
+        while (entries_.size() > capacity_) {
+            auto last = std::prev(entries_.end());
+            auto range = index_.equal_range(last->key.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == last) {
+                    index_.erase(it);
+                    break;
+                }
+            }
+            entries_.pop_back();
+        }
+        
+        return baked;
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        entries_.clear();
+    }
+
+private:
+    struct Key {
+        std::vector<CurvePoint> points;
+        CurveType type;
+        int32_t lut_size;
+        ColorChannel channel;
+        uint64_t hash;
+        
+        bool operator==(const Key& other) const {
+            return type == other.type && lut_size == other.lut_size &&
+                   channel == other.channel && points.size() == other.points.size() &&
+                   std::equal(points.begin(), points.end(), other.points.begin(),
+                              [](const CurvePoint& a, const CurvePoint& b) {
+                                  return a.x == b.x && a.y == b.y;
+                              });
+        }
+    };
+    
+    struct Entry {
+        Key key;
+        std::shared_ptr<const BakedCurveLUT> baked;
+    };
+    
+    static Key makeKey(const CurveData& curve) {
+        Key key;
+        key.points.assign(curve.points, curve.points + curve.point_count);
+        key.type = curve.type;
+        key.lut_size = curve.lut_size > 1 ? curve.lut_size : DEFAULT_LUT_SIZE;
+        key.channel = curve.channel;
+        
+        // FNV-1a over the fields that determine the LUT
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        // Points go in whole words: composed curves carry thousands
+        for (const CurvePoint& point : key.points) {
+            uint64_t words[2];
+            std::memcpy(words, &point, sizeof(words));
+            hash = (hash ^ words[0]) * 1099511628211ull;
+            hash = (hash ^ words[1]) * 1099511628211ull;
+        }
+        mix(&key.type, sizeof(key.type));
+        mix(&key.lut_size, sizeof(key.lut_size));
+        mix(&key.channel, sizeof(key.channel));
+        key.hash = hash;
+        
+        return key;
+    }
+    
+    size_t capacity_;
+    std::mutex mutex_;
+    std::list<Entry> entries_;
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index_;
+};
+
+/**
+ * Per-channel curve assignment for a single apply pass
+ * A null entry leaves that channel untouched; alpha is always copied.
+ */
+struct ChannelLUTSet {
+    std::shared_ptr<const BakedCurveLUT> channel[3];
+    std::shared_ptr<const BakedCurveLUT> luminance;   // Applied after the channel curves
+    std::shared_ptr<const BakedCurveLUT> lab[3];      // L, a, b; applied last
+    bool swap_bytes = false;   // 16-bit samples are stored in the other byte order
+    
+    /**
+     * Distribute one curve according to its ColorChannel
+     */
+    static ChannelLUTSet forChannel(std::shared_ptr<const BakedCurveLUT> baked,
+                                    ColorChannel channel) {
+        ChannelLUTSet set;
+        switch (channel) {
+            case CHANNEL_RGB:
+                set.channel[0] = set.channel[1] = set.channel[2] = baked;
+                break;
+            case CHANNEL_LUMINANCE:
+                set.luminance = baked;
+                break;
+            case CHANNEL_RED:
+                set.channel[0] = baked;
+                break;
+            case CHANNEL_GREEN:
+                set.channel[1] = baked;
+                break;
+            case CHANNEL_BLUE:
+                set.channel[2] = baked;
+                break;
+            case CHANNEL_LAB_L:
+                set.lab[0] = baked;
+                break;
+            case CHANNEL_LAB_A:
+                set.lab[1] = baked;
+                break;
+            case CHANNEL_LAB_B:
+                set.lab[2] = baked;
+                break;
+            default:
+                break;
+        }
+        return set;
+    }
+    
+    bool hasLab() const {
+        return lab[0] || lab[1] || lab[2];
+    }
+    
+    /**
+     * Bit c set when channel c has a curve; selects the kernel variant
+     */
+    uint32_t curvedMask() const {
+        return (channel[0] ? 1u : 0u) | (channel[1] ? 2u : 0u) | (channel[2] ? 4u : 0u);
+    }
+};
+
+/**
+ * Baked 3D LUT: size^3 RGB nodes over normalized sample values, red
+ * varying fastest
+ * The grid spans [domain_min, domain_max] per channel; baked LUTs use
+ * [0, 1], .cube files may declare their own domain.
+ */
+class ColorLUT3D {
+public:
+    ColorLUT3D(int32_t size, std::vector<float> data) : size_(size), data_(std::move(data)) {}
+    
+    ColorLUT3D(int32_t size, std::vector<float> data,
+               const float domain_min[3], const float domain_max[3])
+        : size_(size), data_(std::move(data)) {
+        std::copy(domain_min, domain_min + 3, domain_min_);
+        std::copy(domain_max, domain_max + 3, domain_max_);
+    }
+    
+    int32_t size() const { return size_; }
+    const std::vector<float>& data() const { return data_; }
+    const float* domainMin() const { return domain_min_; }
+    const float* domainMax() const { return domain_max_; }
+    
+    Kernels::Lut3DTable table() const {
+        Kernels::Lut3DTable table = {data_.data(), size_, {}, {}};
+        for (int c = 0; c < 3; ++c) {
+            table.scale[c] = static_cast<float>(size_ - 1) / (domain_max_[c] - domain_min_[c]);
+            table.offset[c] = -domain_min_[c] * table.scale[c];
+        }
+        return table;
+    }
+    
+private:
+    int32_t size_;
+    std::vector<float> data_;
+    float domain_min_[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max_[3] = {1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * Parsed .cube files keyed by path
+ * An entry is reused while the file's size and modification time are
+ * unchanged, so batch jobs that load the same look for every image parse
+ * it once.
+ */
+class CubeLUTCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+    
+    explicit CubeLUTCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+    
+    CurveResult acquire(const std::string& path,
+                        std::shared_ptr<const ColorLUT3D>* lut,
+                        bool* hit) {
+        MappedFile::Stamp stamp;
+        if (!MappedFile::stamp(path, &stamp)) {
+            return CURVE_ERROR_FILE_IO;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (it->path == path && it->stamp == stamp) {
+                    entries_.splice(entries_.begin(), entries_, it);
+                    *lut = it->lut;
+                    if (hit) *hit = true;
+                    return CURVE_SUCCESS;
+                }
+            }
+        }
+        
+        // Parse outside the lock so loading one look doesn't stall others
+        MappedFile file;
+        if (!file.open(path, MappedFile::Mode::READ_ONLY)) {
+            return CURVE_ERROR_FILE_IO;
+        }
+        file.adviseSequential();
+        
+        CubeLUT cube;
+        if (!parseCubeFile(reinterpret_cast<const char*>(file.data()), file.size(), &cube)) {
+            return CURVE_ERROR_UNSUPPORTED_FORMAT;
+        }
+        auto parsed = std::make_shared<const ColorLUT3D>(cube.size, std::move(cube.data),
+                                                         cube.domain_min, cube.domain_max);
+        if (hit) *hit = false;
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.remove_if([&path](const Entry& entry) { return entry.path == path; });
+        entries_.push_front({path, stamp, parsed});
+        while (entries_.size() > capacity_) {
+            entries_.pop_back();
+        }
+        
+        *lut = parsed;
+        return CURVE_SUCCESS;
+    }
+    
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+private:
+    struct Entry {
+        std::string path;
+        MappedFile::Stamp stamp;
+        std::shared_ptr<const ColorLUT3D> lut;
+    };
+    
+    size_t capacity_;
+    std::mutex mutex_;
+    std::list<Entry> entries_;
+};
+
+/**
+ * Performance-optimized image processor
+ * Uses SIMD and multi-threading based on reverse engineering insights
+ */
+class ImageCurveProcessor {
+public:
+    /**
+     * @param pool Engine worker pool; null runs on the calling thread
+     */
+    static void applyLUTToImage(const ChannelLUTSet& luts,
+                               const ImageData& input,
+                               ImageData& output,
+                               const ProcessingOptions& options,
+                               ThreadPool* pool) {
+        
+        if (options.use_gpu && isGPUAvailable()) {
+            applyLUTGPU(luts, input, output, options, pool);
+            return;
+        }
+        
+        // CPU implementation with SIMD optimization
+        applyLUTCPU(luts, input, output, options, pool);
+    }
+    
+    /**
+     * Apply a 3D LUT; input must have 3 or 4 channels
+     */
+    static void applyLUT3DToImage(const ColorLUT3D& lut,
+                                  const ImageData& input,
+                                  ImageData& output,
+                                  const ProcessingOptions& options,
+                                  ThreadPool* pool) {
+        
+        Kernels::Lut3DTable table = lut.table();
+        const Kernels::KernelTable& kernels = Kernels::activeKernels();
+        Kernels::KernelImage view = kernelView(input, output);
+        int32_t layout = Kernels::lumaLayout(view.channels);
+        
+        Kernels::ApplyLut3DFn kernel = nullptr;
+        switch (input.format) {
+            case FORMAT_RGB8:
+            case FORMAT_RGBA8:
+                kernel = kernels.apply_lut3d8[layout];
+                break;
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16:
+                kernel = kernels.apply_lut3d16[layout][0];
+                break;
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F:
+                kernel = kernels.apply_lut3d_float[layout];
+                break;
+        }
+        
+        runBanded(view, options, pool,
+                  [&](const Kernels::KernelImage& band) { kernel(band, table); },
+                  outputHistogram(options, input.format, false));
+    }
+
+private:
+    // Bands smaller than this cost more to hand out than they save
+    static constexpr int64_t MIN_BAND_PIXELS = 32768;
+    
+    // Bands per thread, so faster threads can pick up the slack
+    static constexpr int32_t BANDS_PER_THREAD = 4;
+    
+    // Pixels written between histogram updates; small enough to still be
+    // in cache when they are read back
+    static constexpr int64_t HISTOGRAM_CHUNK_PIXELS = 16384;
+    
+    /**
+     * Histogram bins private to one band: red, green, blue, then luma
+     */
+    using HistogramBins = std::array<uint64_t, 4 * CURVE_HISTOGRAM_BINS>;
+    using AccumulateFn = void (*)(const Kernels::KernelImage& image, HistogramBins& bins);
+    
+    /**
+     * Where a pass accumulates ProcessingOptions::output_histogram
+     */
+    struct OutputHistogram {
+        CurveHistogram* target = nullptr;
+        AccumulateFn accumulate = nullptr;
+    };
+    
+    static void applyLUTCPU(const ChannelLUTSet& luts,
+                           const ImageData& input,
+                           ImageData& output,
+                           const ProcessingOptions& options,
+                           ThreadPool* pool) {
+        
+        // Gray buffers have no chroma: luma is the sample itself, so
+        // luminance and Lab L curves are just curves on channel 0, and
+        // Lab a/b curves have nothing to act on
+        if (input.channels < 3 && (luts.luminance || luts.hasLab())) {
+            ChannelLUTSet gray = luts;
+            gray.luminance.reset();
+            for (auto& component : gray.lab) {
+                component.reset();
+            }
+            
+            auto append = [&](std::shared_ptr<const BakedCurveLUT> next) {
+                gray.channel[0] = gray.channel[0]
+                    ? BakedCurveLUT::compose(*gray.channel[0], *next)
+                    : next;
+            };
+            if (luts.luminance) {
+                append(luts.luminance);
+            }
+            if (luts.lab[0]) {
+                bool linear = input.format == FORMAT_RGB32F || input.format == FORMAT_RGBA32F;
+                append(BakedCurveLUT::grayLightness(*luts.lab[0], linear));
+            }
+            applyChannelCurves(gray, input, output, options, pool);
+            return;
+        }
+        
+        // Channel curves first, then the luminance and Lab passes, each over
+        // the previous result (in place, which the kernels allow). Only the
+        // last pass writes final pixels, so only it fills the histogram.
+        ProcessingOptions earlier = options;
+        earlier.output_histogram = nullptr;
+        
+        const ImageData* source = &input;
+        if (luts.curvedMask() != 0 || (!luts.luminance && !luts.hasLab())) {
+            bool last = !luts.luminance && !luts.hasLab();
+            applyChannelCurves(luts, input, output, last ? options : earlier, pool);
+            source = &output;
+        }
+        if (luts.luminance) {
+            applyLuminance(luts, *source, output, luts.hasLab() ? earlier : options, pool);
+            source = &output;
+        }
+        if (luts.hasLab()) {
+            applyLab(luts, *source, output, options, pool);
+        }
+    }
+    
+    static void applyChannelCurves(const ChannelLUTSet& luts,
+                                   const ImageData& input,
+                                   ImageData& output,
+                                   const ProcessingOptions& options,
+                                   ThreadPool* pool) {
+        
+        switch (input.format) {
+            case FORMAT_RGB8:
+            case FORMAT_RGBA8:
+                // 8-bit images can only index 256 positions of the LUT, so
+                // bake those once and run a pure table lookup kernel
+                applyLUT8(luts, input, output, options, pool);
+                break;
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16:
+                applyLUT16(luts, input, output, options, pool);
+                break;
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F:
+                applyLUT32F(luts, input, output, options, pool);
+                break;
+        }
+    }
+    
+    /**
+     * Split the view into row bands and run the kernel on each band
+     * across the pool. Small images stay on the calling thread.
+     * With a histogram requested, each band reads back what the kernel
+     * wrote a few rows at a time, while it is still in cache, into bins
+     * of its own; the bins are summed into the target at the end.
+     */
+    template <typename Kernel>
+    static void runBanded(const Kernels::KernelImage& view,
+                          const ProcessingOptions& options,
+                          ThreadPool* pool,
+                          const Kernel& kernel,
+                          const OutputHistogram& histogram = {}) {
+        
+        int64_t pixels = static_cast<int64_t>(view.width) * view.height;
+        int32_t threads = pool ? pool->concurrency() : 1;
+        if (options.thread_count > 0) {
+            threads = std::min(threads, options.thread_count);
+        }
+        
+        int64_t max_bands = std::min<int64_t>({static_cast<int64_t>(threads) * BANDS_PER_THREAD,
+                                               pixels / MIN_BAND_PIXELS,
+                                               view.height});
+        int32_t band_rows = view.height;
+        int32_t band_count = 1;
+        if (threads > 1 && max_bands > 1) {
+            band_rows = static_cast<int32_t>((view.height + max_bands - 1) / max_bands);
+            band_count = (view.height + band_rows - 1) / band_rows;
+        }
+        
+        std::vector<HistogramBins> bins(histogram.target ? band_count : 0);
+        int32_t chunk_rows = static_cast<int32_t>(
+            std::max<int64_t>(1, HISTOGRAM_CHUNK_PIXELS / std::max(view.width, 1)));
+        
+        auto runBand = [&](int32_t band) {
+            int32_t first_row = band * band_rows;
+            Kernels::KernelImage band_view = view;
+            band_view.src += static_cast<size_t>(first_row) * view.src_stride;
+            band_view.dst += static_cast<size_t>(first_row) * view.dst_stride;
+            band_view.height = std::min(band_rows, view.height - first_row);
+            if (!histogram.target) {
+                kernel(band_view);
+                return;
+            }
+            
+            for (int32_t row = 0; row < band_view.height; row += chunk_rows) {
+                Kernels::KernelImage chunk = band_view;
+                chunk.src += static_cast<size_t>(row) * view.src_stride;
+                chunk.dst += static_cast<size_t>(row) * view.dst_stride;
+                chunk.height = std::min(chunk_rows, band_view.height - row);
+                kernel(chunk);
+                histogram.accumulate(chunk, bins[band]);
+            }
+        };
+        
+        if (band_count == 1) {
+            runBand(0);
+        } else {
+            pool->parallelFor(band_count, threads, runBand);
+        }
+        
+        if (histogram.target) {
+            uint64_t* target[4] = {histogram.target->red, histogram.target->green,
+                                   histogram.target->blue, histogram.target->luma};
+            for (int h = 0; h < 4; ++h) {
+                for (int bin = 0; bin < CURVE_HISTOGRAM_BINS; ++bin) {
+                    uint64_t total = 0;
+                    for (const HistogramBins& band_bins : bins) {
+                        total += band_bins[h * CURVE_HISTOGRAM_BINS + bin];
+                    }
+                    target[h][bin] = total;
+                }
+            }
+        }
+    }
+    
+    static OutputHistogram outputHistogram(const ProcessingOptions& options,
+                                           ImageFormat format,
+                                           bool swap_bytes) {
+        OutputHistogram histogram;
+        histogram.target = options.output_histogram;
+        switch (format) {
+            case FORMAT_RGB8:
+            case FORMAT_RGBA8:
+                histogram.accumulate = accumulateHistogram8;
+                break;
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16:
+                histogram.accumulate = swap_bytes ? accumulateHistogram16<true>
+                                                  : accumulateHistogram16<false>;
+                break;
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F:
+                histogram.accumulate = accumulateHistogramFloat;
+                break;
+        }
+        return histogram;
+    }
+    
+    /**
+     * Count the destination pixels of image
+     * bin(sample) and luma(r, g, b) give bin indices.
+     */
+    template <typename T, typename Bin, typename Luma>
+    static void accumulateHistogram(const Kernels::KernelImage& image, HistogramBins& bins,
+                                    const Bin& bin, const Luma& luma) {
+        uint64_t* red = bins.data();
+        uint64_t* green = red + CURVE_HISTOGRAM_BINS;
+        uint64_t* blue = green + CURVE_HISTOGRAM_BINS;
+        uint64_t* lumas = blue + CURVE_HISTOGRAM_BINS;
+        int32_t channels = image.channels;
+        
+        for (int32_t y = 0; y < image.height; ++y) {
+            const T* row = reinterpret_cast<const T*>(image.dst + y * image.dst_stride);
+            if (channels < 3) {
+                // Gray images count their one channel in every histogram
+                for (int32_t x = 0; x < image.width; ++x) {
+                    int32_t value = bin(row[x * channels]);
+                    ++red[value];
+                    ++green[value];
+                    ++blue[value];
+                    ++lumas[value];
+                }
+                continue;
+            }
+            for (int32_t x = 0; x < image.width; ++x) {
+                const T* pixel = row + x * channels;
+                ++red[bin(pixel[0])];
+                ++green[bin(pixel[1])];
+                ++blue[bin(pixel[2])];
+                ++lumas[luma(pixel[0], pixel[1], pixel[2])];
+            }
+        }
+    }
+    
+    static void accumulateHistogram8(const Kernels::KernelImage& image, HistogramBins& bins) {
+        accumulateHistogram<uint8_t>(
+            image, bins, [](uint8_t value) { return static_cast<int32_t>(value); },
+            [](uint32_t r, uint32_t g, uint32_t b) {
+                return static_cast<int32_t>((Kernels::LUMA8_WEIGHTS[0] * r +
+                                             Kernels::LUMA8_WEIGHTS[1] * g +
+                                             Kernels::LUMA8_WEIGHTS[2] * b + 128) >> 8);
+            });
+    }
+    
+    template <bool Swapped>
+    static void accumulateHistogram16(const Kernels::KernelImage& image, HistogramBins& bins) {
+        auto native = [](uint16_t value) -> uint32_t {
+            return Swapped ? swapBytes16(value) : value;
+        };
+        accumulateHistogram<uint16_t>(
+            image, bins, [&](uint16_t value) { return static_cast<int32_t>(native(value) >> 8); },
+            [&](uint16_t r, uint16_t g, uint16_t b) {
+                uint32_t luma = (Kernels::LUMA16_WEIGHTS[0] * native(r) +
+                                 Kernels::LUMA16_WEIGHTS[1] * native(g) +
+                                 Kernels::LUMA16_WEIGHTS[2] * native(b) + 32768u) >> 16;
+                return static_cast<int32_t>(luma >> 8);
+            });
+    }
+    
+    static void accumulateHistogramFloat(const Kernels::KernelImage& image, HistogramBins& bins) {
+        auto bin = [](double value) {
+            // NaN lands in bin 0 along with negatives
+            return value >= 1.0 ? CURVE_HISTOGRAM_BINS - 1
+                 : value > 0.0  ? static_cast<int32_t>(value * CURVE_HISTOGRAM_BINS)
+                                : 0;
+        };
+        // Luma in double, where the products are exact, as the analysis
+        // kernels compute it
+        accumulateHistogram<float>(image, bins, bin, [&](float r, float g, float b) {
+            return bin(double(Kernels::LUMA_WEIGHT_R) * r + double(Kernels::LUMA_WEIGHT_G) * g +
+                       double(Kernels::LUMA_WEIGHT_B) * b);
+        });
+    }
+    
+    static uint16_t swapBytes16(uint16_t value) {
+        return static_cast<uint16_t>((value << 8) | (value >> 8));
+    }
+    
+    static Kernels::KernelImage kernelView(const ImageData& input, ImageData& output) {
+        Kernels::KernelImage view;
+        view.src = static_cast<const uint8_t*>(input.data);
+        view.dst = static_cast<uint8_t*>(output.data);
+        view.src_stride = input.stride;
+        view.dst_stride = output.stride;
+        view.width = input.width;
+        view.height = input.height;
+        view.channels = input.channels;
+        return view;
+    }
+    
+    static void applyLUT8(const ChannelLUTSet& luts,
+                          const ImageData& input,
+                          ImageData& output,
+                          const ProcessingOptions& options,
+                          ThreadPool* pool) {
+        
+        // Channels without a curve are copied by the selected kernel
+        const uint8_t* tables[3] = {};
+        for (int c = 0; c < 3; ++c) {
+            if (luts.channel[c]) tables[c] = luts.channel[c]->table8();
+        }
+        
+        Kernels::KernelImage view = kernelView(input, output);
+        Kernels::ApplyLUT8Fn kernel = Kernels::activeKernels()
+            .apply_lut8[Kernels::kernelLayout(view.channels)][luts.curvedMask()];
+        runBanded(view, options, pool,
+                  [&](const Kernels::KernelImage& band) { kernel(band, tables); },
+                  outputHistogram(options, input.format, luts.swap_bytes));
+    }
+    
+    static void applyLUT16(const ChannelLUTSet& luts,
+                           const ImageData& input,
+                           ImageData& output,
+                           const ProcessingOptions& options,
+                           ThreadPool* pool) {
+        
+        // Full-resolution tables: every 16-bit code maps directly, no
+        // interpolation or float conversion in the inner loop
+        const uint16_t* tables[3] = {};
+        for (int c = 0; c < 3; ++c) {
+            if (!luts.channel[c]) continue;
+            tables[c] = luts.swap_bytes ? luts.channel[c]->table16Swapped()
+                                        : luts.channel[c]->table16();
+        }
+        
+        Kernels::KernelImage view = kernelView(input, output);
+        Kernels::ApplyLUT16Fn kernel = Kernels::activeKernels()
+            .apply_lut16[Kernels::kernelLayout(view.channels)][luts.curvedMask()];
+        runBanded(view, options, pool,
+                  [&](const Kernels::KernelImage& band) { kernel(band, tables); },
+                  outputHistogram(options, input.format, luts.swap_bytes));
+    }
+    
+    /**
+     * Float kernel for linear RGB32F/RGBA32F buffers
+     * Samples are clamped to the curve domain [0, 1] before lookup; the
+     * LUT is linearly interpolated exactly like the integer bakers.
+     */
+    static void applyLUT32F(const ChannelLUTSet& luts,
+                            const ImageData& input,
+                            ImageData& output,
+                            const ProcessingOptions& options,
+                            ThreadPool* pool) {
+        
+        // Channels may use tables of different sizes, so the kernels
+        // gather from one concatenated buffer with per-channel offsets
+        std::vector<float> packed;
+        Kernels::FloatLUTs float_luts = {};
+        for (int c = 0; c < 3; ++c) {
+            if (!luts.channel[c]) continue;
+            const std::vector<float>& table = luts.channel[c]->tableFloat();
+            float_luts.offset[c] = static_cast<int32_t>(packed.size());
+            float_luts.size[c] = static_cast<int32_t>(table.size());
+            packed.insert(packed.end(), table.begin(), table.end());
+        }
+        float_luts.data = packed.data();
+        
+        Kernels::KernelImage view = kernelView(input, output);
+        Kernels::ApplyLUTFloatFn kernel = Kernels::activeKernels()
+            .apply_lut_float[Kernels::kernelLayout(view.channels)][luts.curvedMask()];
+        runBanded(view, options, pool,
+                  [&](const Kernels::KernelImage& band) { kernel(band, float_luts); },
+                  outputHistogram(options, input.format, luts.swap_bytes));
+    }
+    
+    /**
+     * Luminance mode: scale RGB by curve(luma) / luma in one pass
+     */
+    static void applyLuminance(const ChannelLUTSet& luts,
+                               const ImageData& input,
+                               ImageData& output,
+                               const ProcessingOptions& options,
+                               ThreadPool* pool) {
+        
+        const BakedCurveLUT& curve = *luts.luminance;
+        const Kernels::KernelTable& kernels = Kernels::activeKernels();
+        Kernels::KernelImage view = kernelView(input, output);
+        int32_t layout = Kernels::lumaLayout(view.channels);
+        
+        switch (input.format) {
+            case FORMAT_RGB8:
+            case FORMAT_RGBA8: {
+                Kernels::LumaTables8 tables = curve.lumaTables8();
+                Kernels::ApplyLuma8Fn kernel = kernels.apply_luma8[layout];
+                runBanded(view, options, pool,
+                          [&](const Kernels::KernelImage& band) { kernel(band, tables); },
+                          outputHistogram(options, input.format, luts.swap_bytes));
+                break;
+            }
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16: {
+                Kernels::LumaTables16 tables = curve.lumaTables16();
+                Kernels::ApplyLuma16Fn kernel = kernels.apply_luma16[layout][luts.swap_bytes];
+                runBanded(view, options, pool,
+                          [&](const Kernels::KernelImage& band) { kernel(band, tables); },
+                          outputHistogram(options, input.format, luts.swap_bytes));
+                break;
+            }
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F: {
+                const std::vector<float>& table = curve.tableFloat();
+                Kernels::LumaFloat lut = {table.data(), static_cast<int32_t>(table.size())};
+                Kernels::ApplyLumaFloatFn kernel = kernels.apply_luma_float[layout];
+                runBanded(view, options, pool,
+                          [&](const Kernels::KernelImage& band) { kernel(band, lut); },
+                          outputHistogram(options, input.format, luts.swap_bytes));
+                break;
+            }
+        }
+    }
+    
+    /**
+     * Lab mode: RGB to Lab, the L/a/b curves and back in one pass
+     */
+    static void applyLab(const ChannelLUTSet& luts,
+                         const ImageData& input,
+                         ImageData& output,
+                         const ProcessingOptions& options,
+                         ThreadPool* pool) {
+        
+        Kernels::LabCurves curves = {};
+        curves.encode = Kernels::srgbEncodeTable();
+        curves.encode8 = Kernels::srgbEncodeTable8();
+        for (int c = 0; c < 3; ++c) {
+            if (luts.lab[c]) {
+                const std::vector<float>& table = luts.lab[c]->tableFloat();
+                curves.lut[c] = table.data();
+                curves.size[c] = static_cast<int32_t>(table.size());
+            }
+        }
+        
+        const Kernels::KernelTable& kernels = Kernels::activeKernels();
+        Kernels::KernelImage view = kernelView(input, output);
+        int32_t layout = Kernels::lumaLayout(view.channels);
+        
+        Kernels::ApplyLabFn kernel = nullptr;
+        switch (input.format) {
+            case FORMAT_RGB8:
+            case FORMAT_RGBA8:
+                curves.decode = Kernels::srgbDecodeTable8();
+                kernel = kernels.apply_lab8[layout];
+                break;
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16:
+                curves.decode = Kernels::srgbDecodeTable16();
+                kernel = kernels.apply_lab16[layout][luts.swap_bytes];
+                break;
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F:
+                kernel = kernels.apply_lab_float[layout];
+                break;
+        }
+        
+        runBanded(view, options, pool,
+                  [&](const Kernels::KernelImage& band) { kernel(band, curves); },
+                  outputHistogram(options, input.format, luts.swap_bytes));
+    }
+    
+    static void applyLUTGPU(const ChannelLUTSet& luts,
+                           const ImageData& input,
+                           ImageData& output,
+                           const ProcessingOptions& options,
+                           ThreadPool* pool) {
+        #ifdef OPENCL_ENABLED
+        // OpenCL implementation
+        // TODO: Implement GPU processing
+        #endif
+        
+        #ifdef DIRECTML_ENABLED
+        // DirectML implementation using discovered operators
+        // TODO: Implement DirectML processing
+        #endif
+        
+        // Fallback to CPU
+        applyLUTCPU(luts, input, output, options, pool);
+    }
+    
+    static bool isGPUAvailable() {
+        #if defined(OPENCL_ENABLED) || defined(DIRECTML_ENABLED)
+        return true;
+        #else
+        return false;
+        #endif
+    }
+};
+
+/**
+ * Progressive preview of curve edits on one source image
+ * In real-time mode an update renders the pyramid level that covers the
+ * viewport on the calling thread, then a worker renders each finer level
+ * down to full resolution. Levels are processed one band of rows at a
+ * time, so the next update stops a refinement within a band instead of
+ * waiting for a whole level.
+ */
+class ProgressivePreview {
+public:
+    /**
+     * Receives each finished level; image is only valid during the call
+     */
+    using Callback = std::function<void(const ImageData& image, int32_t level, bool final)>;
+    
+    // Pixels per band between checks for a newer update
+    static constexpr int64_t BAND_PIXELS = int64_t{1} << 22;
+    
+    ProgressivePreview(const ImageData& source, Callback callback, ThreadPool* pool)
+        : source_(source), callback_(std::move(callback)), pool_(pool) {}
+    
+    ~ProgressivePreview() {
+        cancelRefinement();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+    
+    // Non-copyable
+    ProgressivePreview(const ProgressivePreview&) = delete;
+    ProgressivePreview& operator=(const ProgressivePreview&) = delete;
+    
+    /**
+     * Show a new curve; supersedes any refinement still running
+     * Without options.real_time only the full-resolution image is
+     * rendered, synchronously.
+     */
+    void update(const ChannelLUTSet& luts, int32_t viewport_width, int32_t viewport_height,
+                const ProcessingOptions& options) {
+        uint64_t generation = cancelRefinement();
+        
+        if (!options.real_time) {
+            render(luts, source_, 0, options, generation);
+            return;
+        }
+        
+        // Built on first use and kept for every later edit
+        if (!pyramid_) {
+            pyramid_ = std::make_unique<MipPyramid>(source_, pool_);
+        }
+        
+        int32_t level = pyramid_->levelFor(viewport_width, viewport_height);
+        render(luts, pyramid_->level(level), level, options, generation);
+        if (level == 0) {
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this] { workerLoop(); });
+        }
+        job_ = Job{luts, level - 1, options, generation};
+        has_job_ = true;
+        wake_.notify_one();
+    }
+
+private:
+    struct Job {
+        ChannelLUTSet luts;
+        int32_t first_level;
+        ProcessingOptions options;
+        uint64_t generation;
+    };
+    
+    /**
+     * Stop any refinement and wait until the worker is idle
+     * @return Generation of the update about to start
+     */
+    uint64_t cancelRefinement() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        has_job_ = false;
+        uint64_t generation = generation_.fetch_add(1) + 1;
+        idle_.wait(lock, [this] { return !busy_; });
+        return generation;
+    }
+    
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stopping_ || has_job_; });
+            if (stopping_) {
+                return;
+            }
+            
+            Job job = std::move(job_);
+            has_job_ = false;
+            busy_ = true;
+            lock.unlock();
+            
+            try {
+                for (int32_t level = job.first_level; level >= 0; --level) {
+                    if (!render(job.luts, pyramid_->level(level), level, job.options,
+                                job.generation)) {
+                        break;
+                    }
+                }
+            } catch (const std::exception&) {
+                // A failed refinement leaves the coarser result on screen
+            }
+            
+            lock.lock();
+            busy_ = false;
+            idle_.notify_all();
+        }
+    }
+    
+    /**
+     * Apply luts to one level and hand the result to the callback
+     * @return False when a newer update arrived first
+     */
+    bool render(const ChannelLUTSet& luts, const ImageData& input, int32_t level,
+                const ProcessingOptions& options, uint64_t generation) {
+        if (outputs_.size() <= static_cast<size_t>(level)) {
+            outputs_.resize(level + 1);
+        }
+        
+        // Packed, whatever the padding of the source rows
+        size_t row_bytes = static_cast<size_t>(input.width) * input.channels *
+                           MipPyramid::sampleBytes(input.format);
+        std::vector<uint8_t>& pixels = outputs_[level];
+        pixels.resize(row_bytes * input.height);
+        
+        ImageData output = input;
+        output.data = pixels.data();
+        output.stride = row_bytes;
+        
+        int32_t band_rows = static_cast<int32_t>(
+            std::max<int64_t>(1, BAND_PIXELS / input.width));
+        for (int32_t row = 0; row < input.height; row += band_rows) {
+            if (generation_.load(std::memory_order_relaxed) != generation) {
+                return false;
+            }
+            int32_t rows = std::min(band_rows, input.height - row);
+            ImageData band_input = input;
+            band_input.data = static_cast<uint8_t*>(input.data) + row * input.stride;
+            band_input.height = rows;
+            ImageData band_output = output;
+            band_output.data = pixels.data() + row * row_bytes;
+            band_output.height = rows;
+            ImageCurveProcessor::applyLUTToImage(luts, band_input, band_output, options, pool_);
+        }
+        
+        if (generation_.load(std::memory_order_relaxed) != generation) {
+            return false;
+        }
+        if (callback_) {
+            callback_(output, level, level == 0);
+        }
+        return true;
+    }
+    
+    ImageData source_;
+    Callback callback_;
+    ThreadPool* pool_;
+    std::unique_ptr<MipPyramid> pyramid_;
+    std::vector<std::vector<uint8_t>> outputs_;   // Per level, reused across updates
+    
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::atomic<uint64_t> generation_{0};
+    Job job_{};
+    bool has_job_ = false;
+    bool busy_ = false;
+    bool stopping_ = false;
+};
+
+} // namespace PhotoStudioPro
+
+// =============================================================================
+// Global State Management
+// =============================================================================
+
+/**
+ * Engine context handed out through the C API
+ * Holds everything an apply call mutates, so callers on separate contexts
+ * share no workers, cache lock or statistics. The default context backs
+ * the entry points that take no context.
+ */
+struct CurveContext {
+    std::unique_ptr<PhotoStudioPro::ThreadPool> thread_pool;
+    PhotoStudioPro::CurveLUTCache lut_cache;
+    std::mutex stats_mutex;
+    PerformanceStats stats = {};
+    
+    explicit CurveContext(int32_t worker_count)
+        : thread_pool(std::make_unique<PhotoStudioPro::ThreadPool>(worker_count)) {}
+    
+    /**
+     * Record the time of an operation started at start_time and the LUT
+     * cache lookups it made
+     */
+    void recordOperation(std::chrono::high_resolution_clock::time_point start_time,
+                         int32_t cache_hits = 0,
+                         int32_t cache_misses = 0) {
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            end_time - start_time);
+        
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats.processing_time_ms = duration.count() / 1000.0;
+        stats.cache_hits += cache_hits;
+        stats.cache_misses += cache_misses;
+    }
+    
+    void recordLookup(bool cache_hit) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        ++(cache_hit ? stats.cache_hits : stats.cache_misses);
+    }
+};
+
+namespace {
+    // Written under g_state_mutex; read without it by every entry point
+    std::atomic<bool> g_initialized{false};
+    std::mutex g_state_mutex;
+    std::unique_ptr<CurveContext> g_default_context;
+    PhotoStudioPro::CubeLUTCache g_cube_cache;
+    std::chrono::high_resolution_clock::time_point g_last_operation_time;
+    
+    #ifdef DIRECTML_ENABLED
+    std::unique_ptr<DirectMLProcessor> g_directml_processor;
+    #endif
+    
+    #ifdef OPENCL_ENABLED
+    std::unique_ptr<OpenCLProcessor> g_opencl_processor;
+    #endif
+    
+    /**
+     * Context of the entry points that take none; null before curve_initialize
+     */
+    CurveContext* defaultContext() {
+        return g_initialized.load(std::memory_order_acquire) ? g_default_context.get() : nullptr;
+    }
+    
+    /**
+     * Workers for a context running on thread_count threads (0: one per
+     * hardware thread); the calling thread is the +1
+     */
+    int32_t workerCount(int32_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = static_cast<int32_t>(std::thread::hardware_concurrency());
+        }
+        return std::max(thread_count, 1) - 1;
+    }
+    
+    size_t bytesPerSample(ImageFormat format) {
+        switch (format) {
+            case FORMAT_RGB16:
+            case FORMAT_RGBA16:
+                return sizeof(uint16_t);
+            case FORMAT_RGB32F:
+            case FORMAT_RGBA32F:
+                return sizeof(float);
+            default:
+                return sizeof(uint8_t);
+        }
+    }
+    
+    /**
+     * Validate an input/output pair for the apply entry points
+     * The kernels read each sample before writing it and never revisit
+     * it, so an output that exactly aliases the input (same data and
+     * stride) is safe. Any other overlap would read rows that were already
+     * overwritten.
+     */
+    CurveResult validateImagePair(const ImageData& input, const ImageData& output) {
+        if (!input.data || !output.data || input.width <= 0 || input.height <= 0) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        if (input.format < FORMAT_RGB8 || input.format > FORMAT_RGBA32F) {
+            return CURVE_ERROR_UNSUPPORTED_FORMAT;
+        }
+        
+        if (output.format != input.format || output.channels != input.channels ||
+            output.width != input.width || output.height != input.height) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        if (input.channels < 1 || input.channels > 4) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        // Rows must not overlap their neighbours
+        size_t row_bytes = static_cast<size_t>(input.width) * input.channels *
+                           bytesPerSample(input.format);
+        if (input.stride < row_bytes || output.stride < row_bytes) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        if (input.data == output.data) {
+            return input.stride == output.stride ? CURVE_SUCCESS : CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        size_t input_span = input.stride * (input.height - 1) + row_bytes;
+        size_t output_span = output.stride * (output.height - 1) + row_bytes;
+        auto input_begin = reinterpret_cast<uintptr_t>(input.data);
+        auto output_begin = reinterpret_cast<uintptr_t>(output.data);
+        if (input_begin < output_begin + output_span && output_begin < input_begin + input_span) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        return CURVE_SUCCESS;
+    }
+    
+    /**
+     * Pick the buffer an apply call writes to
+     * In-place calls write back into input; output may be null or must
+     * describe the same buffer.
+     */
+    CurveResult resolveOutput(const ImageData* input,
+                              ImageData* output,
+                              const ProcessingOptions* options,
+                              ImageData* target) {
+        if (options && options->in_place) {
+            if (output && (output->data != input->data || output->stride != input->stride)) {
+                return CURVE_ERROR_INVALID_PARAMS;
+            }
+            *target = *input;
+        } else {
+            if (!output) {
+                return CURVE_ERROR_INVALID_PARAMS;
+            }
+            *target = *output;
+        }
+        
+        return validateImagePair(*input, *target);
+    }
+    
+    /**
+     * Sub-image view of a rectangle, addressed through the parent stride
+     */
+    ImageData regionView(const ImageData& image, int32_t x, int32_t y,
+                         int32_t width, int32_t height) {
+        size_t pixel_bytes = static_cast<size_t>(image.channels) * bytesPerSample(image.format);
+        ImageData region = image;
+        region.data = static_cast<uint8_t*>(image.data) +
+                      static_cast<size_t>(y) * image.stride + static_cast<size_t>(x) * pixel_bytes;
+        region.width = width;
+        region.height = height;
+        return region;
+    }
+    
+    /**
+     * Run ColorEnhancementModel over the nodes of a 16-bit RGB grid
+     * The model works on 8-bit BGR, so the nodes round-trip through it.
+     */
+    void enhanceGrid(std::vector<uint16_t>& samples, const ColorEnhanceParams& params) {
+        size_t nodes = samples.size() / 3;
+        cv::Mat bgr(1, static_cast<int>(nodes), CV_8UC3);
+        uint8_t* pixels = bgr.ptr<uint8_t>(0);
+        for (size_t i = 0; i < nodes; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                pixels[i * 3 + 2 - c] = static_cast<uint8_t>((samples[i * 3 + c] * 255u + 32767u) / 65535u);
+            }
+        }
+        
+        PhotoStudioPro::ColorEnhancementSettings settings;
+        settings.saturation_boost = params.saturation_boost;
+        settings.vibrance = params.vibrance;
+        settings.temperature = params.temperature;
+        settings.tint = params.tint;
+        
+        PhotoStudioPro::ColorEnhancementModel model;
+        cv::Mat enhanced = model.enhanceColors(bgr, settings);
+        if (enhanced.type() != CV_8UC3 || enhanced.total() != nodes || !enhanced.isContinuous()) {
+            throw std::runtime_error("color enhancement changed the grid layout");
+        }
+        
+        const uint8_t* result = enhanced.ptr<uint8_t>(0);
+        for (size_t i = 0; i < nodes; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                samples[i * 3 + c] = static_cast<uint16_t>(result[i * 3 + 2 - c] * 257);
+            }
+        }
+    }
+    
+    /**
+     * Apply one baked curve and record the processing time
+     */
+    CurveResult applyBaked(CurveContext& context,
+                           std::shared_ptr<const PhotoStudioPro::BakedCurveLUT> baked,
+                           ColorChannel channel,
+                           const ImageData& input,
+                           ImageData& target,
+                           const ProcessingOptions* options) {
+        try {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            
+            // Apply processing options
+            ProcessingOptions opts = options ? *options : ProcessingOptions{};
+            
+            // Apply LUT to image
+            PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(
+                PhotoStudioPro::ChannelLUTSet::forChannel(std::move(baked), channel),
+                input, target, opts, context.thread_pool.get());
+            
+            context.recordOperation(start_time);
+            return CURVE_SUCCESS;
+            
+        } catch (const std::bad_alloc&) {
+            return CURVE_ERROR_OUT_OF_MEMORY;
+        } catch (const std::exception&) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+    }
+    
+    /**
+     * Shared body of the single-curve apply entry points
+     */
+    CurveResult applyCurve(CurveContext& context,
+                           const CurveData& curve,
+                           const ImageData& input,
+                           ImageData& target,
+                           const ProcessingOptions* options) {
+        try {
+            // Reuse the baked lookup table when this curve was seen before
+            bool cache_hit = false;
+            auto baked = context.lut_cache.acquire(curve, &cache_hit);
+            context.recordLookup(cache_hit);
+            
+            return applyBaked(context, std::move(baked), curve.channel, input, target, options);
+            
+        } catch (const std::bad_alloc&) {
+            return CURVE_ERROR_OUT_OF_MEMORY;
+        } catch (const std::exception&) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+    }
+}
+
+/**
+ * Baked 3D LUT handed out through the C API
+ */
+struct CurveLUT3D {
+    std::shared_ptr<const PhotoStudioPro::ColorLUT3D> lut;
+};
+
+/**
+ * Curve being edited point by point
+ * curve is a read-only CurveData view of the editor's points, kept in
+ * step with every move.
+ */
+struct CurveEditor {
+    PhotoStudioPro::IncrementalCurveLUT lut;
+    CurveData curve;
+};
+
+/**
+ * Progressive preview handed out through the C API
+ */
+struct CurvePreview {
+    std::unique_ptr<PhotoStudioPro::ProgressivePreview> preview;
+};
+
+/**
+ * Streaming session state
+ * Holds the baked tables for the whole session; pixel memory always
+ * belongs to the caller's current band.
+ */
+struct CurveStream {
+    CurveContext* context;
+    PhotoStudioPro::ChannelLUTSet luts;
+    ProcessingOptions options;
+    ImageFormat format;
+    int32_t width;
+    int32_t channels;
+};
+
+// =============================================================================
+// C API Implementation
+// =============================================================================
+
+extern "C" {
+
+CURVE_API CurveResult CURVE_CALL curve_initialize(void) {
+    std::lock_guard<std::mutex> lock(g_state_mutex);
+    
+    if (g_initialized) {
+        return CURVE_SUCCESS;
+    }
+    
+    try {
+        // Initialize performance tracking
+        g_last_operation_time = std::chrono::high_resolution_clock::now();
+        
+        // Pick pixel kernels for this CPU (or CURVE_FORCE_ISA)
+        PhotoStudioPro::Kernels::initializeKernels();
+        
+        // Workers and cache live until curve_cleanup
+        g_default_context = std::make_unique<CurveContext>(workerCount(0));
+        
+        #ifdef DIRECTML_ENABLED
+        g_directml_processor = std::make_unique<DirectMLProcessor>();
+        if (!g_directml_processor->initialize()) {
+            // DirectML not available, continue without AI features
+            g_directml_processor.reset();
+        }
+        #endif
+        
+        #ifdef OPENCL_ENABLED
+        g_opencl_processor = std::make_unique<OpenCLProcessor>();
+        if (!g_opencl_processor->initialize()) {
+            // OpenCL not available, continue without GPU acceleration
+            g_opencl_processor.reset();
+        }
+        #endif
+        
+        g_initialized.store(true, std::memory_order_release);
+        return CURVE_SUCCESS;
+        
+    } catch (const std::exception&) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+}
+
+CURVE_API void CURVE_CALL curve_cleanup(void) {
+    std::lock_guard<std::mutex> lock(g_state_mutex);
+    
+    if (!g_initialized) return;
+    
+    #ifdef DIRECTML_ENABLED
+    g_directml_processor.reset();
+    #endif
+    
+    #ifdef OPENCL_ENABLED
+    g_opencl_processor.reset();
+    #endif
+    
+    g_initialized.store(false, std::memory_order_release);
+    g_default_context.reset();
+    g_cube_cache.clear();
+}
+
+CURVE_API const char* CURVE_CALL curve_get_version(void) {
+    return "1.0.0-rev183ops";  // Version includes reference to 183 operators
+}
 
 CURVE_API bool CURVE_CALL curve_is_gpu_available(void) {
     #if defined(OPENCL_ENABLED) || defined(DIRECTML_ENABLED)
@@ -498,157 +2378,1163 @@ CURVE_API bool CURVE_CALL curve_is_gpu_available(void) {
     #endif
 }
 
-CURVE_API bool CURVE_CALL curve_is_ai_available(void) {
-    #ifdef DIRECTML_ENABLED
-    return g_directml_processor != nullptr;
-    #else
-    return false;
-    #endif
+CURVE_API bool CURVE_CALL curve_is_ai_available(void) {
+    #ifdef DIRECTML_ENABLED
+    return g_directml_processor != nullptr;
+    #else
+    return false;
+    #endif
+}
+
+CURVE_API int32_t CURVE_CALL curve_get_ml_operator_count(void) {
+    #ifdef DIRECTML_ENABLED
+    return ML_OPERATORS_AVAILABLE;  // 183 from reverse engineering
+    #else
+    return 0;
+    #endif
+}
+
+CURVE_API CurveResult CURVE_CALL curve_set_isa_level(CurveIsaLevel level) {
+    using PhotoStudioPro::Kernels::IsaLevel;
+    
+    IsaLevel kernel_level;
+    switch (level) {
+        case CURVE_ISA_AUTO:    kernel_level = PhotoStudioPro::Kernels::detectIsaLevel(); break;
+        case CURVE_ISA_GENERIC: kernel_level = IsaLevel::GENERIC; break;
+        case CURVE_ISA_SSE42:   kernel_level = IsaLevel::SSE42; break;
+        case CURVE_ISA_AVX2:    kernel_level = IsaLevel::AVX2; break;
+        case CURVE_ISA_AVX512:  kernel_level = IsaLevel::AVX512; break;
+        default:                return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    return PhotoStudioPro::Kernels::selectIsaLevel(kernel_level)
+               ? CURVE_SUCCESS
+               : CURVE_ERROR_NOT_SUPPORTED;
+}
+
+CURVE_API CurveIsaLevel CURVE_CALL curve_get_isa_level(void) {
+    using PhotoStudioPro::Kernels::IsaLevel;
+    
+    switch (PhotoStudioPro::Kernels::activeKernels().level) {
+        case IsaLevel::SSE42:  return CURVE_ISA_SSE42;
+        case IsaLevel::AVX2:   return CURVE_ISA_AVX2;
+        case IsaLevel::AVX512: return CURVE_ISA_AVX512;
+        default:               return CURVE_ISA_GENERIC;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_create(
+    const CurvePoint* points,
+    int32_t point_count,
+    CurveType type,
+    CurveData** out_curve) {
+    
+    if (!points || point_count < 2 || !out_curve) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!g_initialized) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        auto curve = new CurveData();
+        curve->points = new CurvePoint[point_count];
+        curve->point_count = point_count;
+        curve->type = type;
+        curve->channel = CHANNEL_RGB;
+        curve->gamma = 1.0;
+        curve->black_point = 0.0;
+        curve->white_point = 1.0;
+        curve->lut_size = DEFAULT_LUT_SIZE;
+        
+        // Copy and validate points
+        for (int i = 0; i < point_count; ++i) {
+            curve->points[i].x = std::clamp(points[i].x, 0.0, 1.0);
+            curve->points[i].y = std::clamp(points[i].y, 0.0, 1.0);
+        }
+        
+        // Sort points by x coordinate
+        std::sort(curve->points, curve->points + point_count,
+                  [](const CurvePoint& a, const CurvePoint& b) {
+                      return a.x < b.x;
+                  });
+        
+        *out_curve = curve;
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API void CURVE_CALL curve_destroy(CurveData* curve) {
+    if (curve) {
+        delete[] curve->points;
+        delete curve;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_image(
+    CurveContext* context,
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options) {
+    
+    if (!curve || !input) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    ImageData target;
+    CurveResult validation = resolveOutput(input, output, options, &target);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    return applyCurve(*context, *curve, *input, target, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_apply_to_image(
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options) {
+    
+    return curve_context_apply_to_image(defaultContext(), curve, input, output, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_region(
+    CurveContext* context,
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options) {
+    
+    if (!curve || !input) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    ImageData target;
+    CurveResult validation = resolveOutput(input, output, options, &target);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        width > input->width - x || height > input->height - y) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    // Both images share geometry, so the same rectangle addresses both;
+    // the kernels never see pixels outside it
+    ImageData input_region = regionView(*input, x, y, width, height);
+    ImageData target_region = regionView(target, x, y, width, height);
+    return applyCurve(*context, *curve, input_region, target_region, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_apply_to_region(
+    const CurveData* curve,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options) {
+    
+    return curve_context_apply_to_region(defaultContext(), curve, input, output,
+                                         x, y, width, height, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_apply_multi_channel(
+    CurveContext* context,
+    const CurveData** curves,
+    int32_t curve_count,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options) {
+    
+    if (!curves || curve_count <= 0 || !input) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    ImageData target;
+    CurveResult validation = resolveOutput(input, output, options, &target);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    try {
+        using PhotoStudioPro::BakedCurveLUT;
+        
+        auto start_time = std::chrono::high_resolution_clock::now();
+        int32_t cache_hits = 0;
+        int32_t cache_misses = 0;
+        
+        // Fold the master (RGB) curves, each channel's own curves, the
+        // luminance curves and each Lab component's curves separately, in
+        // array order
+        std::shared_ptr<const BakedCurveLUT> master;
+        std::shared_ptr<const BakedCurveLUT> per_channel[3];
+        std::shared_ptr<const BakedCurveLUT> luminance;
+        std::shared_ptr<const BakedCurveLUT> lab[3];
+        
+        for (int32_t i = 0; i < curve_count; ++i) {
+            const CurveData* curve = curves[i];
+            if (!curve || !curve->points || curve->point_count < 2) {
+                return CURVE_ERROR_INVALID_PARAMS;
+            }
+            
+            std::shared_ptr<const BakedCurveLUT>* slot = nullptr;
+            switch (curve->channel) {
+                case CHANNEL_RGB:
+                    slot = &master;
+                    break;
+                case CHANNEL_LUMINANCE:
+                    slot = &luminance;
+                    break;
+                case CHANNEL_RED:
+                    slot = &per_channel[0];
+                    break;
+                case CHANNEL_GREEN:
+                    slot = &per_channel[1];
+                    break;
+                case CHANNEL_BLUE:
+                    slot = &per_channel[2];
+                    break;
+                case CHANNEL_LAB_L:
+                    slot = &lab[0];
+                    break;
+                case CHANNEL_LAB_A:
+                    slot = &lab[1];
+                    break;
+                case CHANNEL_LAB_B:
+                    slot = &lab[2];
+                    break;
+                default:
+                    return CURVE_ERROR_INVALID_PARAMS;
+            }
+            
+            bool cache_hit = false;
+            auto baked = context->lut_cache.acquire(*curve, &cache_hit);
+            ++(cache_hit ? cache_hits : cache_misses);
+            
+            *slot = *slot ? BakedCurveLUT::compose(**slot, *baked) : baked;
+        }
+        
+        // Channel curves apply on top of the master curve, Lightroom style,
+        // so each channel ends up with exactly one table and every pixel is
+        // touched once
+        PhotoStudioPro::ChannelLUTSet luts;
+        for (int c = 0; c < 3; ++c) {
+            if (master && per_channel[c]) {
+                luts.channel[c] = BakedCurveLUT::compose(*master, *per_channel[c]);
+            } else {
+                luts.channel[c] = per_channel[c] ? per_channel[c] : master;
+            }
+        }
+        luts.luminance = luminance;
+        for (int c = 0; c < 3; ++c) {
+            luts.lab[c] = lab[c];
+        }
+        
+        ProcessingOptions opts = options ? *options : ProcessingOptions{};
+        PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(luts, *input, target, opts,
+                                                             context->thread_pool.get());
+        
+        context->recordOperation(start_time, cache_hits, cache_misses);
+        
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_apply_multi_channel(
+    const CurveData** curves,
+    int32_t curve_count,
+    const ImageData* input,
+    ImageData* output,
+    const ProcessingOptions* options) {
+    
+    return curve_context_apply_multi_channel(defaultContext(), curves, curve_count,
+                                             input, output, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_compose(
+    const CurveData** curves,
+    int32_t curve_count,
+    CurveData** out_curve) {
+    
+    if (!curves || curve_count <= 0 || !out_curve) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    for (int32_t i = 0; i < curve_count; ++i) {
+        const CurveData* curve = curves[i];
+        if (!curve || !curve->points || curve->point_count < 2 ||
+            curve->channel != curves[0]->channel) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+    }
+    
+    try {
+        using PhotoStudioPro::BakedCurveLUT;
+        
+        int32_t cache_hits = 0;
+        int32_t cache_misses = 0;
+        
+        // Each step samples at the finer of the two tables, so the result
+        // has the resolution of the finest input
+        std::shared_ptr<const BakedCurveLUT> composed;
+        for (int32_t i = 0; i < curve_count; ++i) {
+            bool cache_hit = false;
+            auto baked = context->lut_cache.acquire(*curves[i], &cache_hit);
+            ++(cache_hit ? cache_hits : cache_misses);
+            
+            composed = composed ? BakedCurveLUT::compose(*composed, *baked) : baked;
+        }
+        
+        // One linear point per table entry bakes back to the same table
+        const std::vector<double>& lut = composed->lut();
+        int32_t size = static_cast<int32_t>(lut.size());
+        auto points = std::make_unique<CurvePoint[]>(size);
+        for (int32_t i = 0; i < size; ++i) {
+            points[i].x = static_cast<double>(i) / (size - 1);
+            points[i].y = std::clamp(lut[i], 0.0, 1.0);
+        }
+        
+        auto curve = new CurveData();
+        curve->points = points.release();
+        curve->point_count = size;
+        curve->type = CURVE_TYPE_LINEAR;
+        curve->channel = curves[0]->channel;
+        curve->gamma = 1.0;
+        curve->black_point = 0.0;
+        curve->white_point = 1.0;
+        curve->lut_size = size;
+        *out_curve = curve;
+        
+        std::lock_guard<std::mutex> lock(context->stats_mutex);
+        context->stats.cache_hits += cache_hits;
+        context->stats.cache_misses += cache_misses;
+        
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_generate_lut(
+    const CurveData* curve,
+    double** lut,
+    int32_t* lut_size) {
+    
+    if (!curve || !lut || !lut_size) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    try {
+        std::vector<CurvePoint> points(curve->points, 
+                                     curve->points + curve->point_count);
+        auto generated_lut = PhotoStudioPro::LookupTableGenerator::generateOptimizedLUT(
+            points, curve->type, curve->lut_size);
+        
+        *lut_size = generated_lut.size();
+        *lut = new double[*lut_size];
+        std::copy(generated_lut.begin(), generated_lut.end(), *lut);
+        
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_stream_begin(
+    CurveContext* context,
+    const CurveData* curve,
+    ImageFormat format,
+    int32_t width,
+    const ProcessingOptions* options,
+    CurveStream** out_stream) {
+    
+    if (!curve || !out_stream || width <= 0) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (format < FORMAT_RGB8 || format > FORMAT_RGBA32F) {
+        return CURVE_ERROR_UNSUPPORTED_FORMAT;
+    }
+    
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        bool cache_hit = false;
+        auto baked = context->lut_cache.acquire(*curve, &cache_hit);
+        
+        auto stream = std::make_unique<CurveStream>();
+        stream->context = context;
+        stream->luts = PhotoStudioPro::ChannelLUTSet::forChannel(baked, curve->channel);
+        stream->options = options ? *options : ProcessingOptions{};
+        stream->format = format;
+        stream->width = width;
+        stream->channels = (format == FORMAT_RGBA8 || format == FORMAT_RGBA16 ||
+                            format == FORMAT_RGBA32F) ? 4 : 3;
+        
+        context->recordLookup(cache_hit);
+        
+        *out_stream = stream.release();
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_stream_begin(
+    const CurveData* curve,
+    ImageFormat format,
+    int32_t width,
+    const ProcessingOptions* options,
+    CurveStream** out_stream) {
+    
+    return curve_context_stream_begin(defaultContext(), curve, format, width,
+                                      options, out_stream);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_stream_push_rows(
+    CurveStream* stream,
+    const void* input_rows,
+    size_t input_stride,
+    void* output_rows,
+    size_t output_stride,
+    int32_t row_count) {
+    
+    if (!stream || row_count <= 0) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!g_initialized) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    ImageData input = {const_cast<void*>(input_rows), stream->width, row_count,
+                       stream->channels, stream->format, input_stride};
+    ImageData output = {output_rows, stream->width, row_count,
+                        stream->channels, stream->format, output_stride};
+    CurveResult validation = validateImagePair(input, output);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    try {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(
+            stream->luts, input, output, stream->options, stream->context->thread_pool.get());
+        
+        stream->context->recordOperation(start_time);
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API void CURVE_CALL curve_stream_end(CurveStream* stream) {
+    delete stream;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_editor_create(
+    const CurveData* curve,
+    CurveEditor** out_editor) {
+    
+    if (!curve || !curve->points || curve->point_count < 2 || !out_editor) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!g_initialized) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        std::vector<CurvePoint> points(curve->points, curve->points + curve->point_count);
+        int32_t lut_size = curve->lut_size > 1 ? curve->lut_size : DEFAULT_LUT_SIZE;
+        
+        auto editor = std::make_unique<CurveEditor>(CurveEditor{
+            PhotoStudioPro::IncrementalCurveLUT(std::move(points), curve->type, lut_size),
+            *curve});
+        editor->curve.points = const_cast<CurvePoint*>(editor->lut.points().data());
+        editor->curve.lut_size = lut_size;
+        
+        *out_editor = editor.release();
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_move_point(
+    CurveEditor* editor,
+    int32_t index,
+    double x,
+    double y,
+    int32_t* out_first,
+    int32_t* out_count) {
+    
+    if (!editor || index < 0 || index >= editor->curve.point_count ||
+        !std::isfinite(x) || !std::isfinite(y)) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    try {
+        auto span = editor->lut.movePoint(static_cast<size_t>(index), x, y);
+        if (out_first) *out_first = static_cast<int32_t>(span.first);
+        if (out_count) *out_count = static_cast<int32_t>(span.second - span.first);
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API const CurveData* CURVE_CALL curve_editor_get_curve(const CurveEditor* editor) {
+    return editor ? &editor->curve : nullptr;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_editor_get_lut(
+    const CurveEditor* editor,
+    const double** lut,
+    int32_t* lut_size) {
+    
+    if (!editor || !lut || !lut_size) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    const std::vector<double>& master = editor->lut.lut();
+    *lut = master.data();
+    *lut_size = static_cast<int32_t>(master.size());
+    return CURVE_SUCCESS;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_editor_apply_to_region(
+    const CurveEditor* editor,
+    const ImageData* input,
+    ImageData* output,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    const ProcessingOptions* options) {
+    
+    if (!editor || !input) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    ImageData target;
+    CurveResult validation = resolveOutput(input, output, options, &target);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        width > input->width - x || height > input->height - y) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    ImageData input_region = regionView(*input, x, y, width, height);
+    ImageData target_region = regionView(target, x, y, width, height);
+    return applyBaked(*context, editor->lut.baked(), editor->curve.channel,
+                      input_region, target_region, options);
+}
+
+CURVE_API void CURVE_CALL curve_editor_destroy(CurveEditor* editor) {
+    delete editor;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_preview_create(
+    const ImageData* source,
+    CurvePreviewCallback callback,
+    void* user_data,
+    CurvePreview** out_preview) {
+    
+    if (!source || !source->data || source->width <= 0 || source->height <= 0 ||
+        source->channels < 1 || source->channels > 4 || !out_preview) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (source->format < FORMAT_RGB8 || source->format > FORMAT_RGBA32F) {
+        return CURVE_ERROR_UNSUPPORTED_FORMAT;
+    }
+    
+    if (source->stride < static_cast<size_t>(source->width) * source->channels *
+                             bytesPerSample(source->format)) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        PhotoStudioPro::ProgressivePreview::Callback forward;
+        if (callback) {
+            forward = [callback, user_data](const ImageData& image, int32_t level, bool final) {
+                callback(&image, level, final, user_data);
+            };
+        }
+        
+        auto preview = std::make_unique<CurvePreview>();
+        preview->preview = std::make_unique<PhotoStudioPro::ProgressivePreview>(
+            *source, std::move(forward), context->thread_pool.get());
+        *out_preview = preview.release();
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_preview_update(
+    CurvePreview* preview,
+    const CurveData* curve,
+    int32_t viewport_width,
+    int32_t viewport_height,
+    const ProcessingOptions* options) {
+    
+    if (!preview || !curve || viewport_width <= 0 || viewport_height <= 0) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        bool cache_hit = false;
+        auto baked = context->lut_cache.acquire(*curve, &cache_hit);
+        
+        ProcessingOptions opts = options ? *options : ProcessingOptions{};
+        opts.in_place = false;
+        opts.output_histogram = nullptr;
+        preview->preview->update(PhotoStudioPro::ChannelLUTSet::forChannel(baked, curve->channel),
+                                 viewport_width, viewport_height, opts);
+        
+        // Time to the first result; refinement runs on after this
+        context->recordOperation(start_time, cache_hit, !cache_hit);
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
 }
 
-CURVE_API int32_t CURVE_CALL curve_get_ml_operator_count(void) {
-    #ifdef DIRECTML_ENABLED
-    return ML_OPERATORS_AVAILABLE;  // 183 from reverse engineering
-    #else
-    return 0;
-    #endif
+CURVE_API void CURVE_CALL curve_preview_destroy(CurvePreview* preview) {
+    delete preview;
 }
 
-CURVE_API CurveResult CURVE_CALL curve_create(
-    const CurvePoint* points,
-    int32_t point_count,
-    CurveType type,
-    CurveData** out_curve) {
+CURVE_API CurveResult CURVE_CALL curve_context_apply_to_file(
+    CurveContext* context,
+    const CurveData* curve,
+    const char* input_path,
+    const char* output_path,
+    const RasterFileLayout* layout,
+    const ProcessingOptions* options) {
     
-    if (!points || point_count < 2 || !out_curve) {
+    using PhotoStudioPro::MappedFile;
+    
+    if (!curve || !input_path || !output_path) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
     
-    if (!g_initialized) {
+    if (!context) {
         return CURVE_ERROR_NOT_INITIALIZED;
     }
     
     try {
-        auto curve = new CurveData();
-        curve->points = new CurvePoint[point_count];
-        curve->point_count = point_count;
-        curve->type = type;
-        curve->channel = CHANNEL_RGB;
-        curve->gamma = 1.0;
-        curve->black_point = 0.0;
-        curve->white_point = 1.0;
-        curve->lut_size = DEFAULT_LUT_SIZE;
+        auto start_time = std::chrono::high_resolution_clock::now();
         
-        // Copy and validate points
-        for (int i = 0; i < point_count; ++i) {
-            curve->points[i].x = std::clamp(points[i].x, 0.0, 1.0);
-            curve->points[i].y = std::clamp(points[i].y, 0.0, 1.0);
+        bool in_place = MappedFile::isSameFile(input_path, output_path);
+        MappedFile source;
+        if (!source.open(input_path,
+                         in_place ? MappedFile::Mode::READ_WRITE : MappedFile::Mode::READ_ONLY)) {
+            return CURVE_ERROR_FILE_IO;
         }
         
-        // Sort points by x coordinate
-        std::sort(curve->points, curve->points + point_count,
-                  [](const CurvePoint& a, const CurvePoint& b) {
-                      return a.x < b.x;
-                  });
+        RasterFileLayout raster = {};
+        if (layout) {
+            raster = *layout;
+        } else if (!PhotoStudioPro::parsePPMHeader(source.data(), source.size(), &raster)) {
+            return CURVE_ERROR_UNSUPPORTED_FORMAT;
+        }
+        
+        size_t row_bytes = 0;
+        if (!PhotoStudioPro::resolveRasterLayout(&raster, source.size(), &row_bytes)) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+        
+        // 16-bit samples in the foreign byte order go through a swapped
+        // table; float files must match the host
+        bool foreign_order = raster.big_endian != (std::endian::native == std::endian::big);
+        bool is_16bit = raster.format == FORMAT_RGB16 || raster.format == FORMAT_RGBA16;
+        if (foreign_order && bytesPerSample(raster.format) > 1 && !is_16bit) {
+            return CURVE_ERROR_NOT_SUPPORTED;
+        }
+        
+        MappedFile destination;
+        uint8_t* output_base = source.data();
+        if (!in_place) {
+            if (!destination.open(output_path, MappedFile::Mode::CREATE, source.size())) {
+                return CURVE_ERROR_FILE_IO;
+            }
+            output_base = destination.data();
+            
+            // Everything outside the pixels is carried over unchanged
+            size_t raster_end = raster.data_offset +
+                                raster.stride * (raster.height - 1) + row_bytes;
+            std::memcpy(output_base, source.data(), raster.data_offset);
+            std::memcpy(output_base + raster_end, source.data() + raster_end,
+                        source.size() - raster_end);
+            if (raster.stride > row_bytes) {
+                for (int32_t y = 0; y < raster.height; ++y) {
+                    size_t padding = raster.data_offset + raster.stride * y + row_bytes;
+                    std::memcpy(output_base + padding, source.data() + padding,
+                                raster.stride - row_bytes);
+                }
+            }
+            destination.adviseSequential();
+        }
+        source.adviseSequential();
+        
+        int32_t channels = (raster.format == FORMAT_RGBA8 || raster.format == FORMAT_RGBA16 ||
+                            raster.format == FORMAT_RGBA32F) ? 4 : 3;
+        ImageData input = {source.data() + raster.data_offset, raster.width, raster.height,
+                           channels, raster.format, raster.stride};
+        ImageData output = input;
+        output.data = output_base + raster.data_offset;
+        
+        bool cache_hit = false;
+        auto baked = context->lut_cache.acquire(*curve, &cache_hit);
+        auto luts = PhotoStudioPro::ChannelLUTSet::forChannel(baked, curve->channel);
+        luts.swap_bytes = foreign_order && is_16bit;
+        
+        ProcessingOptions opts = options ? *options : ProcessingOptions{};
+        PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(luts, input, output, opts,
+                                                             context->thread_pool.get());
+        
+        context->recordOperation(start_time, cache_hit, !cache_hit);
         
-        *out_curve = curve;
         return CURVE_SUCCESS;
         
     } catch (const std::bad_alloc&) {
         return CURVE_ERROR_OUT_OF_MEMORY;
-    } catch (...) {
+    } catch (const std::exception&) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
 }
 
-CURVE_API void CURVE_CALL curve_destroy(CurveData* curve) {
-    if (curve) {
-        delete[] curve->points;
-        delete curve;
+CURVE_API CurveResult CURVE_CALL curve_apply_to_file(
+    const CurveData* curve,
+    const char* input_path,
+    const char* output_path,
+    const RasterFileLayout* layout,
+    const ProcessingOptions* options) {
+    
+    return curve_context_apply_to_file(defaultContext(), curve, input_path, output_path,
+                                       layout, options);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_lut3d_bake(
+    const Lut3DOp* ops,
+    int32_t op_count,
+    int32_t grid_size,
+    const ProcessingOptions* options,
+    CurveLUT3D** out_lut) {
+    
+    if ((!ops && op_count != 0) || op_count < 0 || !out_lut ||
+        grid_size < 2 || grid_size > MAX_LUT3D_SIZE) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    for (int32_t i = 0; i < op_count; ++i) {
+        if (ops[i].type == LUT3D_OP_CURVE) {
+            const CurveData* curve = ops[i].curve;
+            if (!curve || !curve->points || curve->point_count < 2) {
+                return CURVE_ERROR_INVALID_PARAMS;
+            }
+        } else if (ops[i].type != LUT3D_OP_COLOR_ENHANCE) {
+            return CURVE_ERROR_INVALID_PARAMS;
+        }
+    }
+    
+    try {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        int32_t cache_hits = 0;
+        int32_t cache_misses = 0;
+        
+        // The grid is a 16-bit RGB image, one row per (green, blue) pair,
+        // so curve operations run through the regular image path
+        size_t size = static_cast<size_t>(grid_size);
+        size_t nodes = size * size * size;
+        std::vector<uint16_t> samples(nodes * 3);
+        std::vector<uint16_t> axis(size);
+        for (size_t i = 0; i < size; ++i) {
+            axis[i] = static_cast<uint16_t>((i * 65535 + (size - 1) / 2) / (size - 1));
+        }
+        for (size_t b = 0, node = 0; b < size; ++b) {
+            for (size_t g = 0; g < size; ++g) {
+                for (size_t r = 0; r < size; ++r, ++node) {
+                    samples[node * 3] = axis[r];
+                    samples[node * 3 + 1] = axis[g];
+                    samples[node * 3 + 2] = axis[b];
+                }
+            }
+        }
+        
+        ImageData grid = {samples.data(), grid_size, grid_size * grid_size, 3,
+                          FORMAT_RGB16, size * 3 * sizeof(uint16_t)};
+        ProcessingOptions opts = options ? *options : ProcessingOptions{};
+        opts.output_histogram = nullptr;
+        
+        for (int32_t i = 0; i < op_count; ++i) {
+            if (ops[i].type == LUT3D_OP_CURVE) {
+                bool cache_hit = false;
+                auto baked = context->lut_cache.acquire(*ops[i].curve, &cache_hit);
+                ++(cache_hit ? cache_hits : cache_misses);
+                PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(
+                    PhotoStudioPro::ChannelLUTSet::forChannel(baked, ops[i].curve->channel),
+                    grid, grid, opts, context->thread_pool.get());
+            } else {
+                enhanceGrid(samples, ops[i].enhance);
+            }
+        }
+        
+        std::vector<float> data(nodes * 3);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = samples[i] * (1.0f / 65535.0f);
+        }
+        
+        *out_lut = new CurveLUT3D{
+            std::make_shared<const PhotoStudioPro::ColorLUT3D>(grid_size, std::move(data))};
+        
+        context->recordOperation(start_time, cache_hits, cache_misses);
+        
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
     }
 }
 
-CURVE_API CurveResult CURVE_CALL curve_apply_to_image(
-    const CurveData* curve,
+CURVE_API CurveResult CURVE_CALL curve_apply_3dlut(
+    const CurveLUT3D* lut,
     const ImageData* input,
     ImageData* output,
     const ProcessingOptions* options) {
     
-    if (!curve || !input || !output) {
+    if (!lut || !input) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
     
-    if (!g_initialized) {
+    CurveContext* context = defaultContext();
+    if (!context) {
         return CURVE_ERROR_NOT_INITIALIZED;
     }
     
+    ImageData target;
+    CurveResult validation = resolveOutput(input, output, options, &target);
+    if (validation != CURVE_SUCCESS) {
+        return validation;
+    }
+    
+    if (input->channels != 3 && input->channels != 4) {
+        return CURVE_ERROR_UNSUPPORTED_FORMAT;
+    }
+    
     try {
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        // Generate optimized lookup table
-        std::vector<CurvePoint> points(curve->points, 
-                                     curve->points + curve->point_count);
-        auto lut = PhotoStudioPro::LookupTableGenerator::generateOptimizedLUT(
-            points, curve->type, curve->lut_size);
-        
-        // Apply processing options
         ProcessingOptions opts = options ? *options : ProcessingOptions{};
+        PhotoStudioPro::ImageCurveProcessor::applyLUT3DToImage(*lut->lut, *input, target, opts,
+                                                               context->thread_pool.get());
         
-        // Apply LUT to image
-        PhotoStudioPro::ImageCurveProcessor::applyLUTToImage(
-            lut, *input, *output, curve->channel, opts);
-        
-        // Update performance statistics
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-            end_time - start_time);
-        g_perf_stats.processing_time_ms = duration.count() / 1000.0;
+        context->recordOperation(start_time);
         
         return CURVE_SUCCESS;
         
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
     } catch (const std::exception&) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
 }
 
-CURVE_API CurveResult CURVE_CALL curve_generate_lut(
-    const CurveData* curve,
-    double** lut,
-    int32_t* lut_size) {
+CURVE_API CurveResult CURVE_CALL curve_lut3d_load_cube(
+    const char* path,
+    CurveLUT3D** out_lut) {
     
-    if (!curve || !lut || !lut_size) {
+    if (!path || !out_lut) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
     
+    CurveContext* context = defaultContext();
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
     try {
-        std::vector<CurvePoint> points(curve->points, 
-                                     curve->points + curve->point_count);
-        auto generated_lut = PhotoStudioPro::LookupTableGenerator::generateOptimizedLUT(
-            points, curve->type, curve->lut_size);
+        bool cache_hit = false;
+        std::shared_ptr<const PhotoStudioPro::ColorLUT3D> lut;
+        CurveResult result = g_cube_cache.acquire(path, &lut, &cache_hit);
+        if (result != CURVE_SUCCESS) {
+            return result;
+        }
         
-        *lut_size = generated_lut.size();
-        *lut = new double[*lut_size];
-        std::copy(generated_lut.begin(), generated_lut.end(), *lut);
+        *out_lut = new CurveLUT3D{std::move(lut)};
+        
+        context->recordLookup(cache_hit);
         
         return CURVE_SUCCESS;
         
     } catch (const std::bad_alloc&) {
         return CURVE_ERROR_OUT_OF_MEMORY;
-    } catch (...) {
+    } catch (const std::exception&) {
+        return CURVE_ERROR_FILE_IO;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_lut3d_save_cube(
+    const CurveLUT3D* lut,
+    const char* path,
+    const char* title) {
+    
+    using PhotoStudioPro::MappedFile;
+    
+    if (!lut || !path) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
+    
+    try {
+        const PhotoStudioPro::ColorLUT3D& source = *lut->lut;
+        PhotoStudioPro::CubeLUT cube;
+        cube.title = title ? title : "";
+        cube.size = source.size();
+        std::copy(source.domainMin(), source.domainMin() + 3, cube.domain_min);
+        std::copy(source.domainMax(), source.domainMax() + 3, cube.domain_max);
+        cube.data = source.data();
+        
+        std::string text = PhotoStudioPro::formatCubeFile(cube);
+        MappedFile file;
+        if (!file.open(path, MappedFile::Mode::CREATE, text.size())) {
+            return CURVE_ERROR_FILE_IO;
+        }
+        std::memcpy(file.data(), text.data(), text.size());
+        
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_FILE_IO;
+    }
 }
 
-CURVE_API CurveResult CURVE_CALL curve_get_performance_stats(
+CURVE_API void CURVE_CALL curve_lut3d_destroy(CurveLUT3D* lut) {
+    delete lut;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_analyze_image(
+    CurveContext* context,
+    const ImageData* image,
+    CurveImageStats* stats) {
+    
+    if (!image || !image->data || image->width <= 0 || image->height <= 0 ||
+        image->channels < 1 || image->channels > 4 || !stats) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (image->format < FORMAT_RGB8 || image->format > FORMAT_RGBA32F) {
+        return CURVE_ERROR_UNSUPPORTED_FORMAT;
+    }
+    
+    if (image->stride < static_cast<size_t>(image->width) * image->channels *
+                            bytesPerSample(image->format)) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        PhotoStudioPro::analyzeImage(*image, context->thread_pool.get(), *stats);
+        context->recordOperation(start_time);
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+
+CURVE_API CurveResult CURVE_CALL curve_analyze_image(
+    const ImageData* image,
+    CurveImageStats* stats) {
+    
+    return curve_context_analyze_image(defaultContext(), image, stats);
+}
+
+CURVE_API CurveResult CURVE_CALL curve_ai_analyze_image(
+    const ImageData* image,
+    double* contrast_score,
+    double* shadow_clipping,
+    double* highlight_clipping,
+    double* color_cast) {
+    
+    if (!contrast_score || !shadow_clipping || !highlight_clipping || !color_cast) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    CurveImageStats stats;
+    CurveResult result = curve_analyze_image(image, &stats);
+    if (result != CURVE_SUCCESS) {
+        return result;
+    }
+    
+    const double* means = stats.channel_mean;
+    *contrast_score = std::sqrt(stats.luma_variance);
+    *shadow_clipping = stats.shadow_clipping;
+    *highlight_clipping = stats.highlight_clipping;
+    *color_cast = std::max({means[0], means[1], means[2]}) -
+                  std::min({means[0], means[1], means[2]});
+    return CURVE_SUCCESS;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_create(
+    int32_t thread_count,
+    CurveContext** out_context) {
+    
+    if (thread_count < 0 || !out_context) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    if (!g_initialized) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    try {
+        *out_context = new CurveContext(workerCount(thread_count));
+        return CURVE_SUCCESS;
+        
+    } catch (const std::bad_alloc&) {
+        return CURVE_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception&) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+}
+    
+CURVE_API void CURVE_CALL curve_context_destroy(CurveContext* context) {
+    delete context;
+}
+
+CURVE_API CurveResult CURVE_CALL curve_context_get_performance_stats(
+    CurveContext* context,
     PerformanceStats* stats) {
     
     if (!stats) {
         return CURVE_ERROR_INVALID_PARAMS;
     }
     
-    std::lock_guard<std::mutex> lock(g_state_mutex);
-    *stats = g_perf_stats;
+    if (!context) {
+        return CURVE_ERROR_NOT_INITIALIZED;
+    }
+    
+    std::lock_guard<std::mutex> lock(context->stats_mutex);
+    *stats = context->stats;
     return CURVE_SUCCESS;
 }
 
+CURVE_API CurveResult CURVE_CALL curve_get_performance_stats(
+    PerformanceStats* stats) {
+    
+    if (!stats) {
+        return CURVE_ERROR_INVALID_PARAMS;
+    }
+    
+    // Nothing has run before curve_initialize
+    CurveContext* context = defaultContext();
+    if (!context) {
+        *stats = PerformanceStats{};
+        return CURVE_SUCCESS;
+    }
+    
+    return curve_context_get_performance_stats(context, stats);
+}
+
 } // extern "C"
\ No newline at end of file
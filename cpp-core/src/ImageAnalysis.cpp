@@ -0,0 +1,125 @@
+/*
+ * Image Analysis - Single-Pass Image Statistics
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "ImageAnalysis.h"
+
+#include "ThreadPool.h"
+#include "kernels/CurveKernels.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace PhotoStudioPro {
+
+namespace {
+
+// Pixels handed to a thread at a time
+constexpr int64_t BAND_PIXELS = 65536;
+
+static_assert(Kernels::ANALYSIS_BINS == CURVE_HISTOGRAM_BINS,
+              "analysis kernels bin like CurveHistogram");
+
+/**
+ * Count, mean and sum of squared deviations of luma
+ */
+struct Moments {
+    double count = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    /**
+     * Fold in another set (Chan et al.'s pairwise update)
+     */
+    void merge(const Moments& other) {
+        if (other.count == 0.0) {
+            return;
+        }
+        double total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * (other.count / total);
+        m2 += other.m2 + delta * delta * (count * other.count / total);
+        count = total;
+    }
+};
+
+Kernels::AnalyzeFn analysisKernel(const ImageData& image) {
+    const Kernels::KernelTable& kernels = Kernels::activeKernels();
+    int32_t layout = Kernels::kernelLayout(image.channels);
+    switch (image.format) {
+        case FORMAT_RGB16:
+        case FORMAT_RGBA16:
+            return kernels.analyze16[layout][0];
+        case FORMAT_RGB32F:
+        case FORMAT_RGBA32F:
+            return kernels.analyze_float[layout];
+        default:
+            return kernels.analyze8[layout];
+    }
+}
+
+} // namespace
+
+void analyzeImage(const ImageData& image, ThreadPool* pool, CurveImageStats& stats) {
+    Kernels::AnalyzeFn kernel = analysisKernel(image);
+    Kernels::KernelImage view = {static_cast<const uint8_t*>(image.data), nullptr,
+                                 image.stride, 0, image.width, image.height, image.channels};
+
+    int32_t band_rows = static_cast<int32_t>(
+        std::max<int64_t>(1, BAND_PIXELS / image.width));
+    int32_t band_count = (image.height + band_rows - 1) / band_rows;
+    std::vector<Kernels::AnalysisSums> bands(band_count);
+
+    auto analyzeBand = [&](int32_t band) {
+        int32_t first_row = band * band_rows;
+        Kernels::KernelImage band_view = view;
+        band_view.src += static_cast<size_t>(first_row) * view.src_stride;
+        band_view.height = std::min(band_rows, image.height - first_row);
+        kernel(band_view, bands[band]);
+    };
+
+    if (pool) {
+        pool->parallelFor(band_count, 0, analyzeBand);
+    } else {
+        for (int32_t band = 0; band < band_count; ++band) {
+            analyzeBand(band);
+        }
+    }
+
+    stats = CurveImageStats{};
+    Moments luma;
+    double channel[3] = {0.0, 0.0, 0.0};
+    uint64_t shadows = 0;
+    uint64_t highlights = 0;
+    for (int32_t band = 0; band < band_count; ++band) {
+        const Kernels::AnalysisSums& sums = bands[band];
+        Moments band_luma;
+        band_luma.count = static_cast<double>(image.width) *
+                          std::min(band_rows, image.height - band * band_rows);
+        band_luma.mean = sums.pivot + sums.luma / band_luma.count;
+        band_luma.m2 = std::max(0.0, sums.luma_squares - sums.luma * sums.luma / band_luma.count);
+        luma.merge(band_luma);
+
+        for (int32_t bin = 0; bin < CURVE_HISTOGRAM_BINS; ++bin) {
+            stats.luma_histogram[bin] += sums.histogram[bin];
+        }
+        for (int32_t c = 0; c < 3; ++c) {
+            channel[c] += sums.channel[c];
+        }
+        shadows += sums.shadows;
+        highlights += sums.highlights;
+    }
+
+    stats.pixel_count = static_cast<uint64_t>(image.width) * image.height;
+    stats.luma_mean = luma.mean;
+    stats.luma_variance = luma.m2 / luma.count;
+    for (int32_t c = 0; c < 3; ++c) {
+        stats.channel_mean[c] = channel[c] / luma.count;
+    }
+    stats.shadow_clipping = 100.0 * shadows / luma.count;
+    stats.highlight_clipping = 100.0 * highlights / luma.count;
+}
+
+} // namespace PhotoStudioPro
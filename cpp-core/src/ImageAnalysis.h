@@ -0,0 +1,24 @@
+/*
+ * Image Analysis - Single-Pass Image Statistics
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include "AdvancedCurveProcessor.h"
+
+namespace PhotoStudioPro {
+
+class ThreadPool;
+
+/**
+ * Gather the statistics of image in one read of its pixels
+ * Row bands are analyzed in parallel on pool (null runs on the calling
+ * thread) and merged with the pairwise mean/variance update, so the
+ * result does not depend on the band split beyond rounding. image must
+ * be valid: 1-4 channels, a supported format and a large enough stride.
+ */
+void analyzeImage(const ImageData& image, ThreadPool* pool, CurveImageStats& stats);
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,144 @@
+/*
+ * Mip Pyramid - Reduced Copies of an Image for Previews
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "MipPyramid.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace PhotoStudioPro {
+
+namespace {
+
+// Output rows handed to a thread at a time
+constexpr int64_t BAND_PIXELS = 65536;
+
+inline uint8_t average4(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return static_cast<uint8_t>((a + b + c + d + 2u) >> 2);
+}
+
+inline uint16_t average4(uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+    return static_cast<uint16_t>((a + b + c + d + 2u) >> 2);
+}
+
+inline float average4(float a, float b, float c, float d) {
+    return ((a + b) + (c + d)) * 0.25f;
+}
+
+/**
+ * Reduce output rows [first_row, end_row) of dst from src
+ */
+template <typename T, int C>
+void reduceRows(const ImageData& src, const ImageData& dst, int32_t first_row, int32_t end_row) {
+    int32_t pairs = src.width / 2;
+    bool odd_width = src.width % 2 != 0;
+
+    for (int32_t y = first_row; y < end_row; ++y) {
+        auto row = [&src](int32_t index) {
+            return reinterpret_cast<const T*>(static_cast<const uint8_t*>(src.data) +
+                                              static_cast<size_t>(index) * src.stride);
+        };
+        const T* top = row(2 * y);
+        const T* bottom = row(std::min(2 * y + 1, src.height - 1));
+        T* out = reinterpret_cast<T*>(static_cast<uint8_t*>(dst.data) +
+                                      static_cast<size_t>(y) * dst.stride);
+
+        for (int32_t x = 0; x < pairs; ++x) {
+            for (int c = 0; c < C; ++c) {
+                out[x * C + c] = average4(top[2 * x * C + c], top[(2 * x + 1) * C + c],
+                                          bottom[2 * x * C + c], bottom[(2 * x + 1) * C + c]);
+            }
+        }
+        if (odd_width) {
+            const T* left = top + 2 * pairs * C;
+            const T* below = bottom + 2 * pairs * C;
+            for (int c = 0; c < C; ++c) {
+                out[pairs * C + c] = average4(left[c], left[c], below[c], below[c]);
+            }
+        }
+    }
+}
+
+template <typename T>
+void reduceRows(const ImageData& src, const ImageData& dst, int32_t first_row, int32_t end_row) {
+    switch (src.channels) {
+        case 1: reduceRows<T, 1>(src, dst, first_row, end_row); break;
+        case 2: reduceRows<T, 2>(src, dst, first_row, end_row); break;
+        case 3: reduceRows<T, 3>(src, dst, first_row, end_row); break;
+        default: reduceRows<T, 4>(src, dst, first_row, end_row); break;
+    }
+}
+
+} // namespace
+
+MipPyramid::MipPyramid(const ImageData& source, ThreadPool* pool) {
+    levels_.push_back(source);
+
+    while (std::max(levels_.back().width, levels_.back().height) > MIN_SIZE) {
+        const ImageData& src = levels_.back();
+        ImageData dst = src;
+        dst.width = (src.width + 1) / 2;
+        dst.height = (src.height + 1) / 2;
+        dst.stride = static_cast<size_t>(dst.width) * dst.channels * sampleBytes(dst.format);
+        storage_.emplace_back(dst.stride * dst.height);
+        dst.data = storage_.back().data();
+
+        int32_t band_rows = static_cast<int32_t>(
+            std::max<int64_t>(1, BAND_PIXELS / dst.width));
+        int32_t band_count = (dst.height + band_rows - 1) / band_rows;
+        auto reduceBand = [&](int32_t band) {
+            int32_t first_row = band * band_rows;
+            int32_t end_row = std::min(first_row + band_rows, dst.height);
+            switch (src.format) {
+                case FORMAT_RGB16:
+                case FORMAT_RGBA16:
+                    reduceRows<uint16_t>(src, dst, first_row, end_row);
+                    break;
+                case FORMAT_RGB32F:
+                case FORMAT_RGBA32F:
+                    reduceRows<float>(src, dst, first_row, end_row);
+                    break;
+                default:
+                    reduceRows<uint8_t>(src, dst, first_row, end_row);
+                    break;
+            }
+        };
+
+        if (pool) {
+            pool->parallelFor(band_count, 0, reduceBand);
+        } else {
+            for (int32_t band = 0; band < band_count; ++band) {
+                reduceBand(band);
+            }
+        }
+        levels_.push_back(dst);
+    }
+}
+
+size_t MipPyramid::sampleBytes(ImageFormat format) {
+    switch (format) {
+        case FORMAT_RGB16:
+        case FORMAT_RGBA16:
+            return sizeof(uint16_t);
+        case FORMAT_RGB32F:
+        case FORMAT_RGBA32F:
+            return sizeof(float);
+        default:
+            return sizeof(uint8_t);
+    }
+}
+
+int32_t MipPyramid::levelFor(int32_t width, int32_t height) const {
+    for (int32_t index = levelCount() - 1; index > 0; --index) {
+        if (levels_[index].width >= width || levels_[index].height >= height) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,56 @@
+/*
+ * Mip Pyramid - Reduced Copies of an Image for Previews
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include "AdvancedCurveProcessor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PhotoStudioPro {
+
+class ThreadPool;
+
+/**
+ * Successive 2x box-filtered reductions of an image
+ * Level 0 is the source itself and is not copied, so it must outlive the
+ * pyramid. Each further level halves both sides, rounding up (the last
+ * odd row or column is averaged with itself), until the longer side is
+ * at most MIN_SIZE. Levels keep the source format and channel count.
+ */
+class MipPyramid {
+public:
+    static constexpr int32_t MIN_SIZE = 256;
+
+    MipPyramid(const ImageData& source, ThreadPool* pool);
+
+    // Non-copyable: levels point into storage_
+    MipPyramid(const MipPyramid&) = delete;
+    MipPyramid& operator=(const MipPyramid&) = delete;
+
+    int32_t levelCount() const { return static_cast<int32_t>(levels_.size()); }
+
+    const ImageData& level(int32_t index) const { return levels_[index]; }
+
+    /**
+     * Bytes per sample of a format
+     */
+    static size_t sampleBytes(ImageFormat format);
+
+    /**
+     * Coarsest level at least as large as the image fitted into a
+     * width x height viewport
+     */
+    int32_t levelFor(int32_t width, int32_t height) const;
+
+private:
+    std::vector<ImageData> levels_;
+    std::vector<std::vector<uint8_t>> storage_;   // Pixels of levels 1 and up
+};
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,123 @@
+/*
+ * Thread Pool - Persistent Workers for Pixel Kernels
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace PhotoStudioPro {
+
+ThreadPool::ThreadPool(int32_t worker_count) {
+    workers_.reserve(std::max(worker_count, 0));
+    for (int32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int32_t count, int32_t max_threads, const Task& task) {
+    if (count <= 0) {
+        return;
+    }
+
+    int32_t threads = max_threads > 0 ? std::min(max_threads, concurrency()) : concurrency();
+    threads = std::min(threads, count);
+
+    std::unique_lock<std::mutex> dispatch(dispatch_mutex_, std::try_to_lock);
+    if (threads <= 1 || !dispatch.owns_lock()) {
+        for (int32_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        task_count_ = count;
+        next_index_.store(0, std::memory_order_relaxed);
+        error_ = nullptr;
+        open_slots_ = threads - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runTasks();
+
+    // Every index is claimed by now; close the job to late wakers and wait
+    // for the workers still inside it
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        open_slots_ = 0;
+        done_.wait(lock, [this] { return running_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seen_generation = 0;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+        if (stopping_) {
+            return;
+        }
+
+        seen_generation = generation_;
+        if (open_slots_ == 0) {
+            continue;
+        }
+        --open_slots_;
+        ++running_;
+
+        lock.unlock();
+        runTasks();
+        lock.lock();
+
+        if (--running_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runTasks() {
+    for (;;) {
+        int32_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= task_count_) {
+            return;
+        }
+
+        try {
+            (*task_)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,74 @@
+/*
+ * Thread Pool - Persistent Workers for Pixel Kernels
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PhotoStudioPro {
+
+/**
+ * Fixed set of worker threads owned by the engine
+ * Workers sleep between jobs; a job is a range of task indices claimed
+ * one at a time from an atomic counter, with the calling thread taking
+ * part. One job runs at a time: a caller that finds the pool busy (or
+ * calls in from a task) runs its tasks inline instead of queueing.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void(int32_t index)>;
+
+    /**
+     * @param worker_count Threads to start in addition to the caller
+     */
+    explicit ThreadPool(int32_t worker_count);
+    ~ThreadPool();
+
+    // Non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Threads available to a job, including the caller
+     */
+    int32_t concurrency() const { return static_cast<int32_t>(workers_.size()) + 1; }
+
+    /**
+     * Run task(0) .. task(count - 1) on up to max_threads threads
+     * (0 = all) and return when every task has finished. The first
+     * exception thrown by a task is rethrown here.
+     */
+    void parallelFor(int32_t count, int32_t max_threads, const Task& task);
+
+private:
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> workers_;
+    std::mutex dispatch_mutex_;        // Held by the caller for a whole job
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;          // Bumped once per job
+    int32_t open_slots_ = 0;           // Workers still allowed to join the job
+    int32_t running_ = 0;              // Workers inside the current job
+    bool stopping_ = false;
+
+    const Task* task_ = nullptr;
+    int32_t task_count_ = 0;
+    std::atomic<int32_t> next_index_{0};
+    std::exception_ptr error_;
+};
+
+} // namespace PhotoStudioPro
@@ -482,9 +482,11 @@ CurveData DirectMLProcessor::generateIntelligentCurve(const ImageData& image,
         
         std::vector<CurvePoint> points;
         
-        // Analyze image characteristics
-        double brightness = calculateImageBrightness(image);
-        double contrast = calculateImageContrast(image);
+        // Analyze image characteristics (one pass for both)
+        CurveImageStats stats;
+        bool analyzed = curve_analyze_image(&image, &stats) == CURVE_SUCCESS;
+        double brightness = analyzed ? stats.luma_mean : 0.5;
+        double contrast = analyzed ? std::sqrt(stats.luma_variance) : 0.5;
         
         // Generate intelligent curve based on analysis
         if (params.contrast_boost > 0.5) {
@@ -619,39 +621,17 @@ CurveData DirectMLProcessor::generateFallbackCurve(const ImageData& image,
 }
 
 double DirectMLProcessor::calculateImageBrightness(const ImageData& image) {
-    // Simple brightness calculation
-    if (!image.data || image.format != FORMAT_RGB8) return 0.5;
-    
-    const uint8_t* pixels = static_cast<const uint8_t*>(image.data);
-    double sum = 0.0;
-    int pixel_count = image.width * image.height;
-    
-    for (int i = 0; i < pixel_count * image.channels; i += image.channels) {
-        double luma = 0.299 * pixels[i] + 0.587 * pixels[i+1] + 0.114 * pixels[i+2];
-        sum += luma;
-    }
-    
-    return sum / (pixel_count * 255.0);
+    // Mean luma from the single-pass analysis (any format, honours stride)
+    CurveImageStats stats;
+    if (curve_analyze_image(&image, &stats) != CURVE_SUCCESS) return 0.5;
+    return stats.luma_mean;
 }
 
 double DirectMLProcessor::calculateImageContrast(const ImageData& image) {
-    // Simple contrast calculation based on standard deviation
-    if (!image.data || image.format != FORMAT_RGB8) return 0.5;
-    
-    double brightness = calculateImageBrightness(image);
-    
-    const uint8_t* pixels = static_cast<const uint8_t*>(image.data);
-    double variance = 0.0;
-    int pixel_count = image.width * image.height;
-    
-    for (int i = 0; i < pixel_count * image.channels; i += image.channels) {
-        double luma = 0.299 * pixels[i] + 0.587 * pixels[i+1] + 0.114 * pixels[i+2];
-        luma /= 255.0;
-        variance += (luma - brightness) * (luma - brightness);
-    }
-    
-    variance /= pixel_count;
-    return std::sqrt(variance);
+    // Contrast as the standard deviation of luma
+    CurveImageStats stats;
+    if (curve_analyze_image(&image, &stats) != CURVE_SUCCESS) return 0.5;
+    return std::sqrt(stats.luma_variance);
 }
 
 } // namespace PhotoStudioPro
\ No newline at end of file
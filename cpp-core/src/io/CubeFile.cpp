@@ -0,0 +1,230 @@
+/*
+ * Cube File - .cube 3D LUT Import/Export
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "io/CubeFile.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+namespace PhotoStudioPro {
+
+namespace {
+
+constexpr int32_t MAX_CUBE_SIZE = 256;
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isLetter(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * Cursor over one line of .cube text
+ * Numbers go through from_chars, so parsing ignores the C locale.
+ */
+struct LineReader {
+    const char* pos;
+    const char* end;
+
+    void skipBlanks() {
+        while (pos < end && isBlank(*pos)) ++pos;
+    }
+
+    bool atEnd() {
+        skipBlanks();
+        return pos == end;
+    }
+
+    std::string_view readWord() {
+        skipBlanks();
+        const char* start = pos;
+        while (pos < end && !isBlank(*pos)) ++pos;
+        return std::string_view(start, pos - start);
+    }
+
+    bool readFloat(float* value) {
+        skipBlanks();
+        auto result = std::from_chars(pos, end, *value);
+        if (result.ec != std::errc() || !std::isfinite(*value)) {
+            return false;
+        }
+        pos = result.ptr;
+        return true;
+    }
+
+    bool readInt(int32_t* value) {
+        skipBlanks();
+        auto result = std::from_chars(pos, end, *value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        pos = result.ptr;
+        return true;
+    }
+
+    /**
+     * Quoted title, or the rest of the line for writers that omit quotes
+     */
+    std::string readTitle() {
+        skipBlanks();
+        if (pos < end && *pos == '"') {
+            const char* start = ++pos;
+            while (pos < end && *pos != '"') ++pos;
+            std::string title(start, pos - start);
+            if (pos < end) ++pos;
+            return title;
+        }
+        const char* last = end;
+        while (last > pos && isBlank(last[-1])) --last;
+        std::string title(pos, last - pos);
+        pos = end;
+        return title;
+    }
+};
+
+void appendFloat(std::string& text, float value) {
+    char buffer[48];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                std::chars_format::fixed, 6);
+    text.append(buffer, result.ptr);
+}
+
+void appendTriple(std::string& text, const float* values) {
+    appendFloat(text, values[0]);
+    text += ' ';
+    appendFloat(text, values[1]);
+    text += ' ';
+    appendFloat(text, values[2]);
+    text += '\n';
+}
+
+} // namespace
+
+bool parseCubeFile(const char* text, size_t length, CubeLUT* lut) {
+    CubeLUT result;
+    size_t expected = 0;
+
+    const char* line = text;
+    const char* end = text + length;
+    if (length >= 3 && std::memcmp(text, "\xEF\xBB\xBF", 3) == 0) {
+        line += 3;
+    }
+
+    while (line < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!line_end) line_end = end;
+        LineReader reader{line, line_end};
+        line = line_end < end ? line_end + 1 : end;
+
+        if (reader.atEnd() || *reader.pos == '#') {
+            continue;
+        }
+
+        if (!isLetter(*reader.pos)) {
+            // Table row
+            float rgb[3];
+            if (result.size == 0 || result.data.size() == expected ||
+                !reader.readFloat(&rgb[0]) || !reader.readFloat(&rgb[1]) ||
+                !reader.readFloat(&rgb[2]) || !reader.atEnd()) {
+                return false;
+            }
+            result.data.insert(result.data.end(), rgb, rgb + 3);
+            continue;
+        }
+
+        // Keywords all precede the table
+        if (!result.data.empty()) {
+            return false;
+        }
+
+        std::string_view keyword = reader.readWord();
+        bool valid = true;
+        if (keyword == "TITLE") {
+            result.title = reader.readTitle();
+        } else if (keyword == "LUT_3D_SIZE") {
+            valid = result.size == 0 && reader.readInt(&result.size) &&
+                    result.size >= 2 && result.size <= MAX_CUBE_SIZE;
+            if (valid) {
+                expected = static_cast<size_t>(result.size) * result.size * result.size * 3;
+                result.data.reserve(expected);
+            }
+        } else if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX") {
+            float* domain = keyword == "DOMAIN_MIN" ? result.domain_min : result.domain_max;
+            valid = reader.readFloat(&domain[0]) && reader.readFloat(&domain[1]) &&
+                    reader.readFloat(&domain[2]);
+        } else if (keyword == "LUT_3D_INPUT_RANGE") {
+            float range[2];
+            valid = reader.readFloat(&range[0]) && reader.readFloat(&range[1]);
+            for (int c = 0; c < 3 && valid; ++c) {
+                result.domain_min[c] = range[0];
+                result.domain_max[c] = range[1];
+            }
+        } else if (keyword == "LUT_1D_SIZE" || keyword == "LUT_1D_INPUT_RANGE") {
+            // 1D shaper tables are not supported
+            return false;
+        } else {
+            // Vendor keywords (LUT_IN_VIDEO_RANGE, ...) carry nothing the
+            // table needs
+            continue;
+        }
+
+        if (!valid || !reader.atEnd()) {
+            return false;
+        }
+    }
+
+    if (result.size == 0 || result.data.size() != expected) {
+        return false;
+    }
+    for (int c = 0; c < 3; ++c) {
+        if (!(result.domain_max[c] > result.domain_min[c])) {
+            return false;
+        }
+    }
+
+    *lut = std::move(result);
+    return true;
+}
+
+std::string formatCubeFile(const CubeLUT& lut) {
+    size_t nodes = static_cast<size_t>(lut.size) * lut.size * lut.size;
+    std::string text;
+    text.reserve(nodes * 27 + 256);
+
+    if (!lut.title.empty()) {
+        text += "TITLE \"";
+        for (char c : lut.title) {
+            if (c != '"' && c != '\n' && c != '\r') text += c;
+        }
+        text += "\"\n";
+    }
+    text += "LUT_3D_SIZE ";
+    text += std::to_string(lut.size);
+    text += '\n';
+
+    bool default_domain = true;
+    for (int c = 0; c < 3; ++c) {
+        default_domain = default_domain && lut.domain_min[c] == 0.0f && lut.domain_max[c] == 1.0f;
+    }
+    if (!default_domain) {
+        text += "DOMAIN_MIN ";
+        appendTriple(text, lut.domain_min);
+        text += "DOMAIN_MAX ";
+        appendTriple(text, lut.domain_max);
+    }
+    text += '\n';
+
+    for (size_t i = 0; i < nodes; ++i) {
+        appendTriple(text, &lut.data[i * 3]);
+    }
+    return text;
+}
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,43 @@
+/*
+ * Cube File - .cube 3D LUT Import/Export
+ * Adobe Cube LUT Specification 1.0, as written by Resolve and most
+ * grading tools
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PhotoStudioPro {
+
+/**
+ * Contents of a .cube file with a 3D table
+ */
+struct CubeLUT {
+    std::string title;
+    int32_t size = 0;                       // Nodes per axis
+    float domain_min[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max[3] = {1.0f, 1.0f, 1.0f};
+    std::vector<float> data;                // size^3 RGB triples, red fastest
+};
+
+/**
+ * Parse .cube text
+ * Accepts LF or CRLF lines, '#' comments, DOMAIN_MIN/DOMAIN_MAX and
+ * Resolve's LUT_3D_INPUT_RANGE. Files with a 1D table are rejected, as
+ * are sizes outside 2..256 and a node count other than size^3.
+ */
+bool parseCubeFile(const char* text, size_t length, CubeLUT* lut);
+
+/**
+ * Format a LUT as .cube text; the domain lines are written only when
+ * they differ from [0, 1]
+ */
+std::string formatCubeFile(const CubeLUT& lut);
+
+} // namespace PhotoStudioPro
@@ -0,0 +1,250 @@
+/*
+ * Mapped File - Memory-Mapped File Access
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "io/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PhotoStudioPro {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        #ifdef _WIN32
+        std::swap(file_handle_, other.file_handle_);
+        std::swap(mapping_handle_, other.mapping_handle_);
+        #else
+        std::swap(fd_, other.fd_);
+        #endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t size) {
+    close();
+
+    bool writable = mode != Mode::READ_ONLY;
+    HANDLE file = CreateFileA(path.c_str(),
+                              writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              mode == Mode::CREATE ? CREATE_ALWAYS : OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    file_handle_ = file;
+
+    if (mode == Mode::CREATE) {
+        LARGE_INTEGER length;
+        length.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            close();
+            return false;
+        }
+    } else {
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(file, &length)) {
+            close();
+            return false;
+        }
+        size = static_cast<size_t>(length.QuadPart);
+    }
+
+    // Empty files cannot be mapped
+    if (size == 0) {
+        close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr,
+                                        writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    mapping_handle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+    if (!view) {
+        close();
+        return false;
+    }
+
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_handle_) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        file_handle_ = nullptr;
+    }
+    size_ = 0;
+}
+
+void MappedFile::adviseSequential() {
+    // FILE_FLAG_SEQUENTIAL_SCAN was already passed at open
+}
+
+bool MappedFile::isSameFile(const std::string& a, const std::string& b) {
+    auto identify = [](const std::string& path, BY_HANDLE_FILE_INFORMATION* info) {
+        HANDLE file = CreateFileA(path.c_str(), 0,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        bool ok = GetFileInformationByHandle(file, info) != 0;
+        CloseHandle(file);
+        return ok;
+    };
+
+    BY_HANDLE_FILE_INFORMATION info_a;
+    BY_HANDLE_FILE_INFORMATION info_b;
+    if (!identify(a, &info_a) || !identify(b, &info_b)) {
+        return false;
+    }
+    return info_a.dwVolumeSerialNumber == info_b.dwVolumeSerialNumber &&
+           info_a.nFileIndexHigh == info_b.nFileIndexHigh &&
+           info_a.nFileIndexLow == info_b.nFileIndexLow;
+}
+
+bool MappedFile::stamp(const std::string& path, Stamp* stamp) {
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info)) {
+        return false;
+    }
+    stamp->size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    stamp->modified = static_cast<int64_t>(
+        (static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+        info.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, Mode mode, size_t size) {
+    close();
+
+    int flags = O_RDONLY;
+    if (mode == Mode::READ_WRITE) flags = O_RDWR;
+    if (mode == Mode::CREATE) flags = O_RDWR | O_CREAT | O_TRUNC;
+
+    fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    if (mode == Mode::CREATE) {
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            close();
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (::fstat(fd_, &info) != 0) {
+            close();
+            return false;
+        }
+        size = static_cast<size_t>(info.st_size);
+    }
+
+    if (size == 0) {
+        close();
+        return false;
+    }
+
+    int protection = mode == Mode::READ_ONLY ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* mapping = ::mmap(nullptr, size, protection, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    data_ = static_cast<uint8_t*>(mapping);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+void MappedFile::adviseSequential() {
+    if (data_) {
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+}
+
+bool MappedFile::isSameFile(const std::string& a, const std::string& b) {
+    struct stat info_a;
+    struct stat info_b;
+    if (::stat(a.c_str(), &info_a) != 0 || ::stat(b.c_str(), &info_b) != 0) {
+        return false;
+    }
+    return info_a.st_dev == info_b.st_dev && info_a.st_ino == info_b.st_ino;
+}
+
+bool MappedFile::stamp(const std::string& path, Stamp* stamp) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    #ifdef __APPLE__
+    const struct timespec& modified = info.st_mtimespec;
+    #else
+    const struct timespec& modified = info.st_mtim;
+    #endif
+    stamp->size = static_cast<uint64_t>(info.st_size);
+    stamp->modified = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    return true;
+}
+
+#endif
+
+} // namespace PhotoStudioPro
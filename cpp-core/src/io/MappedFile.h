@@ -0,0 +1,89 @@
+/*
+ * Mapped File - Memory-Mapped File Access
+ * Lets the pixel kernels run directly over file pages
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PhotoStudioPro {
+
+/**
+ * Read-only or read-write mapping of a whole file
+ * Move-only; the mapping is released on destruction.
+ */
+class MappedFile {
+public:
+    enum class Mode {
+        READ_ONLY,     // Existing file, mapped for reading
+        READ_WRITE,    // Existing file, mapped for in-place update
+        CREATE         // New or truncated file of a given size, read-write
+    };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map a file
+     * @param size File size for Mode::CREATE, ignored otherwise
+     * @return false if the file cannot be opened, sized or mapped
+     */
+    bool open(const std::string& path, Mode mode, size_t size = 0);
+
+    void close();
+
+    /**
+     * Tell the OS the mapping will be read front to back once, so it can
+     * read ahead aggressively and drop pages behind the cursor
+     */
+    void adviseSequential();
+
+    /**
+     * True if both paths name the same existing file (hard links and
+     * different spellings included)
+     */
+    static bool isSameFile(const std::string& a, const std::string& b);
+
+    /**
+     * Size and last-write time of a file, for cheap change detection
+     */
+    struct Stamp {
+        uint64_t size = 0;
+        int64_t modified = 0;    // Platform clock units; only compared
+
+        bool operator==(const Stamp& other) const = default;
+    };
+
+    /**
+     * Stamp a file without opening it
+     * @return false if the file does not exist or cannot be queried
+     */
+    static bool stamp(const std::string& path, Stamp* stamp);
+
+    bool isOpen() const { return data_ != nullptr; }
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    #ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+    #else
+    int fd_ = -1;
+    #endif
+};
+
+} // namespace PhotoStudioPro
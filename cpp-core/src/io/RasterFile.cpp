@@ -0,0 +1,119 @@
+/*
+ * Raster File - Uncompressed Raster Layouts
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "io/RasterFile.h"
+
+#include <limits>
+
+namespace PhotoStudioPro {
+
+namespace {
+
+bool isSpace(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Skip whitespace and '#' comments, then read a decimal field
+ */
+bool readHeaderNumber(const uint8_t* data, size_t size, size_t* pos, int64_t* value) {
+    while (*pos < size) {
+        if (isSpace(data[*pos])) {
+            ++*pos;
+        } else if (data[*pos] == '#') {
+            while (*pos < size && data[*pos] != '\n') ++*pos;
+        } else {
+            break;
+        }
+    }
+
+    int64_t result = 0;
+    size_t digits = 0;
+    while (*pos < size && data[*pos] >= '0' && data[*pos] <= '9') {
+        result = result * 10 + (data[*pos] - '0');
+        if (result > std::numeric_limits<int32_t>::max()) {
+            return false;
+        }
+        ++*pos;
+        ++digits;
+    }
+
+    *value = result;
+    return digits > 0;
+}
+
+size_t bytesPerPixel(ImageFormat format) {
+    switch (format) {
+        case FORMAT_RGB8:    return 3;
+        case FORMAT_RGBA8:   return 4;
+        case FORMAT_RGB16:   return 6;
+        case FORMAT_RGBA16:  return 8;
+        case FORMAT_RGB32F:  return 12;
+        case FORMAT_RGBA32F: return 16;
+        default:             return 0;
+    }
+}
+
+} // namespace
+
+bool parsePPMHeader(const uint8_t* data, size_t size, RasterFileLayout* layout) {
+    if (size < 2 || data[0] != 'P' || data[1] != '6') {
+        return false;
+    }
+
+    size_t pos = 2;
+    int64_t width = 0;
+    int64_t height = 0;
+    int64_t max_value = 0;
+    if (!readHeaderNumber(data, size, &pos, &width) ||
+        !readHeaderNumber(data, size, &pos, &height) ||
+        !readHeaderNumber(data, size, &pos, &max_value)) {
+        return false;
+    }
+
+    // Exactly one whitespace byte separates the header from the samples
+    if (pos >= size || !isSpace(data[pos])) {
+        return false;
+    }
+    ++pos;
+
+    if (max_value != 255 && max_value != 65535) {
+        return false;
+    }
+
+    layout->format = max_value == 255 ? FORMAT_RGB8 : FORMAT_RGB16;
+    layout->width = static_cast<int32_t>(width);
+    layout->height = static_cast<int32_t>(height);
+    layout->data_offset = pos;
+    layout->stride = 0;
+    layout->big_endian = max_value == 65535;
+    return true;
+}
+
+bool resolveRasterLayout(RasterFileLayout* layout, size_t file_size, size_t* row_bytes) {
+    size_t pixel_bytes = bytesPerPixel(layout->format);
+    if (pixel_bytes == 0 || layout->width <= 0 || layout->height <= 0) {
+        return false;
+    }
+
+    *row_bytes = pixel_bytes * static_cast<size_t>(layout->width);
+    if (layout->stride == 0) {
+        layout->stride = *row_bytes;
+    }
+    if (layout->stride < *row_bytes || layout->data_offset > file_size) {
+        return false;
+    }
+
+    // Overflow-safe: offset + stride * (height - 1) + row_bytes <= file_size
+    size_t available = file_size - layout->data_offset;
+    if (available < *row_bytes) {
+        return false;
+    }
+    size_t extra_rows = static_cast<size_t>(layout->height - 1);
+    return extra_rows == 0 || (available - *row_bytes) / layout->stride >= extra_rows;
+}
+
+} // namespace PhotoStudioPro
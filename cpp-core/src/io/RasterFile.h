@@ -0,0 +1,29 @@
+/*
+ * Raster File - Uncompressed Raster Layouts
+ * Header parsing for files the engine can process through a mapping
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include "AdvancedCurveProcessor.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace PhotoStudioPro {
+
+/**
+ * Parse a binary PPM (P6) header
+ * Accepts maxval 255 (RGB8) and 65535 (big-endian RGB16); other maxvals
+ * would need rescaling and are rejected.
+ */
+bool parsePPMHeader(const uint8_t* data, size_t size, RasterFileLayout* layout);
+
+/**
+ * Check a layout against a file size and fill in a packed stride
+ * @param row_bytes Receives the pixel bytes per row
+ */
+bool resolveRasterLayout(RasterFileLayout* layout, size_t file_size, size_t* row_bytes);
+
+} // namespace PhotoStudioPro
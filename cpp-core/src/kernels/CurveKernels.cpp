@@ -0,0 +1,170 @@
+/*
+ * Curve Kernels - Runtime ISA Dispatch
+ * CPU feature detection and kernel table selection
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "kernels/CurveKernels.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(CURVE_KERNELS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace PhotoStudioPro {
+namespace Kernels {
+
+// Defined once per ISA translation unit (CurveKernels_<isa>.cpp)
+namespace generic { const KernelTable& kernelTable(); }
+#if defined(CURVE_KERNELS_X86)
+namespace sse42 { const KernelTable& kernelTable(); }
+namespace avx2 { const KernelTable& kernelTable(); }
+namespace avx512 { const KernelTable& kernelTable(); }
+#endif
+
+namespace {
+
+std::atomic<const KernelTable*> g_active_kernels{nullptr};
+
+#if defined(CURVE_KERNELS_X86)
+
+#if defined(_MSC_VER)
+bool cpuHasBit(int leaf, int subleaf, int reg, int bit) {
+    int info[4] = {};
+    __cpuidex(info, leaf, subleaf);
+    return (info[reg] >> bit) & 1;
+}
+
+/**
+ * OS must save the relevant register state on context switch
+ */
+bool osSupportsState(unsigned long long mask) {
+    if (!cpuHasBit(1, 0, 2, 27)) {  // OSXSAVE
+        return false;
+    }
+    return (_xgetbv(0) & mask) == mask;
+}
+#endif
+
+IsaLevel detectCpuLevel() {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    bool sse42 = cpuHasBit(1, 0, 2, 20) && cpuHasBit(1, 0, 2, 23);  // SSE4.2, POPCNT
+    if (!sse42) {
+        return IsaLevel::GENERIC;
+    }
+
+    bool ymm_state = osSupportsState(0x6);     // XMM | YMM
+    bool zmm_state = osSupportsState(0xE6);    // XMM | YMM | opmask | ZMM
+    bool leaf7 = max_leaf >= 7;
+
+    bool avx2 = ymm_state && leaf7 &&
+                cpuHasBit(7, 0, 1, 5) &&       // AVX2
+                cpuHasBit(1, 0, 2, 12);        // FMA
+    bool avx512 = avx2 && zmm_state &&
+                  cpuHasBit(7, 0, 1, 16) &&    // AVX512F
+                  cpuHasBit(7, 0, 1, 17) &&    // AVX512DQ
+                  cpuHasBit(7, 0, 1, 30) &&    // AVX512BW
+                  cpuHasBit(7, 0, 1, 31);      // AVX512VL
+#else
+    __builtin_cpu_init();
+    bool sse42 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    if (!sse42) {
+        return IsaLevel::GENERIC;
+    }
+
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    bool avx512 = avx2 &&
+                  __builtin_cpu_supports("avx512f") &&
+                  __builtin_cpu_supports("avx512bw") &&
+                  __builtin_cpu_supports("avx512dq") &&
+                  __builtin_cpu_supports("avx512vl");
+#endif
+
+    if (avx512) return IsaLevel::AVX512;
+    if (avx2) return IsaLevel::AVX2;
+    return IsaLevel::SSE42;
+}
+
+#else
+
+IsaLevel detectCpuLevel() {
+    return IsaLevel::GENERIC;
+}
+
+#endif
+
+const KernelTable& tableForLevel(IsaLevel level) {
+    switch (level) {
+#if defined(CURVE_KERNELS_X86)
+        case IsaLevel::AVX512: return avx512::kernelTable();
+        case IsaLevel::AVX2:   return avx2::kernelTable();
+        case IsaLevel::SSE42:  return sse42::kernelTable();
+#endif
+        default:               return generic::kernelTable();
+    }
+}
+
+bool parseIsaName(const char* name, IsaLevel* level) {
+    struct Entry { const char* name; IsaLevel level; };
+    static const Entry entries[] = {
+        {"generic", IsaLevel::GENERIC},
+        {"sse42", IsaLevel::SSE42},
+        {"avx2", IsaLevel::AVX2},
+        {"avx512", IsaLevel::AVX512}
+    };
+    for (const Entry& entry : entries) {
+        if (std::strcmp(name, entry.name) == 0) {
+            *level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+IsaLevel detectIsaLevel() {
+    static const IsaLevel level = detectCpuLevel();
+    return level;
+}
+
+void initializeKernels() {
+    IsaLevel level = detectIsaLevel();
+
+    // Unknown names or levels above what the CPU supports are ignored
+    IsaLevel forced;
+    const char* env = std::getenv("CURVE_FORCE_ISA");
+    if (env && parseIsaName(env, &forced) && forced <= level) {
+        level = forced;
+    }
+
+    g_active_kernels.store(&tableForLevel(level), std::memory_order_release);
+}
+
+bool selectIsaLevel(IsaLevel level) {
+    if (level > detectIsaLevel()) {
+        return false;
+    }
+    g_active_kernels.store(&tableForLevel(level), std::memory_order_release);
+    return true;
+}
+
+const KernelTable& activeKernels() {
+    const KernelTable* table = g_active_kernels.load(std::memory_order_acquire);
+    if (!table) {
+        initializeKernels();
+        table = g_active_kernels.load(std::memory_order_acquire);
+    }
+    return *table;
+}
+
+} // namespace Kernels
+} // namespace PhotoStudioPro
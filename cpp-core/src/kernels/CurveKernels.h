@@ -0,0 +1,248 @@
+/*
+ * Curve Kernels - Runtime ISA Dispatch
+ * Hot per-pixel loops compiled once per instruction set level
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PhotoStudioPro {
+namespace Kernels {
+
+/**
+ * Instruction set levels the kernels are built for
+ * Ordered so that a higher value implies every lower level.
+ */
+enum class IsaLevel : int32_t {
+    GENERIC = 0,   // Portable baseline, whatever the compiler targets
+    SSE42 = 1,     // x86-64 with SSE4.2/POPCNT
+    AVX2 = 2,      // AVX2 + FMA
+    AVX512 = 3     // AVX-512 F/BW/DQ/VL
+};
+
+/**
+ * Row-addressed view of a source/destination pixel pair
+ * Kernels walk every row of the view; callers split work by handing
+ * out views of row bands. src and dst may be the same buffer with the
+ * same stride: every kernel reads a sample (or vector of samples) before
+ * writing that position and never reads it again.
+ */
+struct KernelImage {
+    const uint8_t* src;
+    uint8_t* dst;
+    size_t src_stride;     // Bytes per source row
+    size_t dst_stride;     // Bytes per destination row
+    int32_t width;
+    int32_t height;
+    int32_t channels;      // Interleaved samples per pixel (1-4)
+};
+
+/**
+ * Float LUTs packed into one buffer
+ * Only channels set in the kernel's mask are read; alpha is always copied.
+ */
+struct FloatLUTs {
+    const float* data;
+    int32_t offset[3];
+    int32_t size[3];
+};
+
+/**
+ * Kernels are specialized per interleaved layout and per set of curved
+ * channels, so the per-pixel code carries no channel-selection branches.
+ * Layout 0 is the runtime-channel fallback for 1-2 channel buffers.
+ */
+constexpr int32_t KERNEL_LAYOUTS = 3;   // any, 3 (RGB), 4 (RGBA)
+constexpr int32_t KERNEL_MASKS = 8;     // bit c set: colour channel c is curved
+
+inline int32_t kernelLayout(int32_t channels) {
+    return channels == 3 ? 1 : (channels == 4 ? 2 : 0);
+}
+
+// 8-bit: one 256-entry table per curved channel (others may be null)
+using ApplyLUT8Fn = void (*)(const KernelImage& image, const uint8_t* const tables[3]);
+
+// 16-bit: one 65536-entry table per curved channel (others may be null)
+using ApplyLUT16Fn = void (*)(const KernelImage& image, const uint16_t* const tables[3]);
+
+// Float: interpolated lookup, samples clamped to the curve domain [0, 1]
+using ApplyLUTFloatFn = void (*)(const KernelImage& image, const FloatLUTs& luts);
+
+/**
+ * Luminance mode: each pixel's RGB is scaled by curve(Y) / Y with Rec.601
+ * luma Y, so hue and saturation are kept. The gain is capped so the
+ * brightest channel just reaches white instead of clipping on its own.
+ * Pixels with Y == 0 have no ratio and become the curve's black level.
+ */
+constexpr float LUMA_WEIGHT_R = 0.299f;
+constexpr float LUMA_WEIGHT_G = 0.587f;
+constexpr float LUMA_WEIGHT_B = 0.114f;
+
+// Integer weights summing to 1 << 8 and 1 << 16
+constexpr int32_t LUMA8_WEIGHTS[3] = {77, 150, 29};
+constexpr int32_t LUMA16_WEIGHTS[3] = {19595, 38470, 7471};
+
+// Fixed-point fraction bits of the 8-bit gain tables
+constexpr int32_t LUMA8_GAIN_BITS = 12;
+
+struct LumaTables8 {
+    const int32_t* gain;     // [256] curve(Y) / Y by luma, Q12
+    const int32_t* limit;    // [256] largest Q12 gain keeping max channel <= 255
+    int32_t black;           // Output for Y == 0
+};
+
+struct LumaTables16 {
+    const float* gain;       // [65536] curve(Y) / Y by luma
+    float black;             // Output for Y == 0
+};
+
+struct LumaFloat {
+    const float* lut;
+    int32_t size;
+};
+
+using ApplyLuma8Fn = void (*)(const KernelImage& image, const LumaTables8& tables);
+using ApplyLuma16Fn = void (*)(const KernelImage& image, const LumaTables16& tables);
+using ApplyLumaFloatFn = void (*)(const KernelImage& image, const LumaFloat& lut);
+
+// Luminance kernels exist for 3 and 4 channel layouts only
+inline int32_t lumaLayout(int32_t channels) {
+    return channels == 4 ? 1 : 0;
+}
+
+/**
+ * Lab mode: pixels go to CIE Lab (D65), the L, a and b curves run on
+ * normalized components (L / 100, (a + 128) / 255, (b + 128) / 255) and
+ * the result comes back to RGB in the same pass. Integer samples are
+ * sRGB-encoded; float samples are linear light.
+ */
+
+// Linear sRGB to XYZ with rows divided by the white point, so white maps to 1
+constexpr float LAB_RGB_TO_XYZ[3][3] = {
+    {0.4339499f, 0.3762098f, 0.1898403f},
+    {0.2126729f, 0.7151521f, 0.0721750f},
+    {0.0177566f, 0.1094680f, 0.8727755f}
+};
+
+constexpr float LAB_XYZ_TO_RGB[3][3] = {
+    { 3.0799551f, -1.5371390f, -0.5428161f},
+    {-0.9212586f,  1.8760111f,  0.0452475f},
+    { 0.0528874f, -0.2040259f,  1.1511385f}
+};
+
+// Samples over [0, 1] of the interpolated linear to sRGB table (LabTables.h)
+constexpr int32_t SRGB_ENCODE_SIZE = 4097;
+
+// The 8-bit encode table is indexed by float bits: one bucket per exponent
+// and top three mantissa bits over [2^-13, 1), each holding a 16-bit bias
+// and scale that are applied to the next eight mantissa bits
+constexpr int32_t SRGB_ENCODE8_SIZE = 104;
+constexpr int32_t SRGB_ENCODE8_MIN_BITS = (127 - 13) << 23;
+constexpr int32_t SRGB_ENCODE8_MAX_BITS = 0x3f7fffff;   // Largest float below 1
+
+struct LabCurves {
+    const float* decode;     // sRGB code to linear (see LabTables.h); unused for float
+    const float* encode;     // [SRGB_ENCODE_SIZE] linear to sRGB, for 16-bit
+    const uint32_t* encode8; // [SRGB_ENCODE8_SIZE] linear to 8-bit sRGB
+    const float* lut[3];     // L, a, b curves; null leaves the component unchanged
+    int32_t size[3];
+};
+
+// Same signature for every sample format
+using ApplyLabFn = void (*)(const KernelImage& image, const LabCurves& curves);
+
+/**
+ * 3D LUT over normalized sample values: size^3 RGB nodes with red varying
+ * fastest (the .cube order), applied by tetrahedral interpolation. Input
+ * channel c sits at grid position value * scale[c] + offset[c], clamped to
+ * the grid; float outputs are not clamped.
+ */
+struct Lut3DTable {
+    const float* data;    // [size^3 * 3]
+    int32_t size;         // Nodes per axis, >= 2
+    float scale[3];       // (size - 1) / domain width
+    float offset[3];      // -domain_min * scale
+};
+
+using ApplyLut3DFn = void (*)(const KernelImage& image, const Lut3DTable& lut);
+
+/**
+ * Image analysis: one read of src gathering the luma histogram, luma
+ * moments, clipping counts and channel sums. Luma is the Rec.601 luma of
+ * luminance mode (the fixed-point form for 8 and 16-bit samples) on the
+ * normalized scale; it is binned like the output histograms (8-bit by
+ * value, 16-bit by high byte, float by Y * 256 clamped). Moments are
+ * taken about pivot, the luma of the first pixel, so the caller can merge
+ * them without cancellation. Views with fewer than 3 channels count
+ * channel 0 as gray.
+ */
+constexpr int32_t ANALYSIS_BINS = 256;
+
+struct AnalysisSums {
+    uint64_t histogram[ANALYSIS_BINS];
+    double pivot;
+    double luma;            // Sum of Y - pivot
+    double luma_squares;    // Sum of (Y - pivot)^2
+    double channel[3];      // Sums of normalized R, G, B
+    uint64_t shadows;       // Pixels with a channel at or below 0
+    uint64_t highlights;    // Pixels with a channel at or above full scale
+};
+
+// Overwrites sums with the statistics of the view (dst is not used)
+using AnalyzeFn = void (*)(const KernelImage& image, AnalysisSums& sums);
+
+/**
+ * One complete set of kernels built for a single ISA level
+ * Per-channel kernels are indexed [kernelLayout(channels)][curved channel
+ * mask]; luminance, Lab and 3D LUT kernels [lumaLayout(channels)], with the
+ * 16-bit ones also by byte order (1 = samples stored byte-swapped).
+ * Analysis kernels are indexed [kernelLayout(channels)] (and byte order).
+ */
+struct KernelTable {
+    IsaLevel level;
+    const char* name;
+    ApplyLUT8Fn apply_lut8[KERNEL_LAYOUTS][KERNEL_MASKS];
+    ApplyLUT16Fn apply_lut16[KERNEL_LAYOUTS][KERNEL_MASKS];
+    ApplyLUTFloatFn apply_lut_float[KERNEL_LAYOUTS][KERNEL_MASKS];
+    ApplyLuma8Fn apply_luma8[2];
+    ApplyLuma16Fn apply_luma16[2][2];
+    ApplyLumaFloatFn apply_luma_float[2];
+    ApplyLabFn apply_lab8[2];
+    ApplyLabFn apply_lab16[2][2];
+    ApplyLabFn apply_lab_float[2];
+    ApplyLut3DFn apply_lut3d8[2];
+    ApplyLut3DFn apply_lut3d16[2][2];
+    ApplyLut3DFn apply_lut3d_float[2];
+    AnalyzeFn analyze8[KERNEL_LAYOUTS];
+    AnalyzeFn analyze16[KERNEL_LAYOUTS][2];
+    AnalyzeFn analyze_float[KERNEL_LAYOUTS];
+};
+
+/**
+ * Highest level supported by both this CPU (via cpuid) and this build
+ */
+IsaLevel detectIsaLevel();
+
+/**
+ * Select the best level, honouring the CURVE_FORCE_ISA environment
+ * variable ("generic", "sse42", "avx2", "avx512") when it is set
+ */
+void initializeKernels();
+
+/**
+ * Force a specific level, e.g. for benchmarks
+ * @return false if the CPU or the build does not support it
+ */
+bool selectIsaLevel(IsaLevel level);
+
+/**
+ * Kernels for the currently selected level
+ */
+const KernelTable& activeKernels();
+
+} // namespace Kernels
+} // namespace PhotoStudioPro
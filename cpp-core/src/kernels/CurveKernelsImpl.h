@@ -0,0 +1,2015 @@
+/*
+ * Curve Kernels - ISA-Parameterized Implementation
+ *
+ * Included once per ISA translation unit with CURVE_KERNEL_ISA set to
+ * the namespace name and CURVE_KERNEL_LEVEL to the matching IsaLevel.
+ * Each of those TUs is compiled with different target flags, so this
+ * file must not instantiate inline functions or templates from outside
+ * its own namespace (std::min, std::vector, ...): the linker may keep
+ * any one copy of such a function, including one that uses instructions
+ * the running CPU lacks. Everything here stays in an anonymous
+ * namespace and works on plain pointers; kernels are instantiated per
+ * channel layout and curved-channel mask from within that namespace.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "kernels/CurveKernels.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__)
+#define CURVE_KERNEL_AVX512 1
+#elif defined(__AVX2__) && defined(__FMA__)
+#define CURVE_KERNEL_AVX2 1
+#endif
+
+namespace PhotoStudioPro {
+namespace Kernels {
+namespace CURVE_KERNEL_ISA {
+
+namespace {
+
+inline const uint8_t* srcRow(const KernelImage& image, int32_t y) {
+    return image.src + static_cast<size_t>(y) * image.src_stride;
+}
+
+inline uint8_t* dstRow(const KernelImage& image, int32_t y) {
+    return image.dst + static_cast<size_t>(y) * image.dst_stride;
+}
+
+template <uint32_t Mask, int32_t C>
+constexpr bool isCurved() {
+    return C < 3 && ((Mask >> C) & 1u) != 0;
+}
+
+inline bool isCurved(uint32_t mask, int32_t c) {
+    return c < 3 && ((mask >> c) & 1u) != 0;
+}
+
+// =============================================================================
+// Integer table lookup (8-bit and 16-bit)
+// =============================================================================
+
+template <uint32_t Mask, int32_t C, typename T>
+inline T lookupTable(const T* table, T value) {
+    if constexpr (isCurved<Mask, C>()) {
+        return table[value];
+    } else {
+        return value;
+    }
+}
+
+template <typename T, int32_t Channels, uint32_t Mask>
+void applyTable(const KernelImage& image, const T* const tables[3]) {
+    const int32_t width = image.width;
+    const T* t0 = tables[0];
+    const T* t1 = tables[1];
+    const T* t2 = tables[2];
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const T* src = reinterpret_cast<const T*>(srcRow(image, y));
+        T* dst = reinterpret_cast<T*>(dstRow(image, y));
+
+        if constexpr (Channels == 0) {
+            const int32_t channels = image.channels;
+            for (int32_t x = 0; x < width; ++x) {
+                for (int32_t c = 0; c < channels; ++c) {
+                    T value = src[x * channels + c];
+                    dst[x * channels + c] = isCurved(Mask, c) ? tables[c][value] : value;
+                }
+            }
+        } else {
+            for (int32_t x = 0; x < width; ++x) {
+                const T* s = src + x * Channels;
+                T* d = dst + x * Channels;
+                d[0] = lookupTable<Mask, 0>(t0, s[0]);
+                d[1] = lookupTable<Mask, 1>(t1, s[1]);
+                d[2] = lookupTable<Mask, 2>(t2, s[2]);
+                if constexpr (Channels == 4) {
+                    d[3] = s[3];
+                }
+            }
+        }
+    }
+}
+
+template <int32_t Channels, uint32_t Mask>
+void applyLUT8(const KernelImage& image, const uint8_t* const tables[3]) {
+    applyTable<uint8_t, Channels, Mask>(image, tables);
+}
+
+template <int32_t Channels, uint32_t Mask>
+void applyLUT16(const KernelImage& image, const uint16_t* const tables[3]) {
+    applyTable<uint16_t, Channels, Mask>(image, tables);
+}
+
+// =============================================================================
+// Float interpolated lookup
+// =============================================================================
+
+/**
+ * Scalar lookup, the reference for the vector paths
+ */
+inline float sampleLUTFloat(const float* lut, int32_t size, float value) {
+    float clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    float pos = clamped * static_cast<float>(size - 1);
+    int32_t index = static_cast<int32_t>(pos);
+    if (index > size - 2) index = size - 2;
+    float frac = pos - static_cast<float>(index);
+    return lut[index] + frac * (lut[index + 1] - lut[index]);
+}
+
+template <uint32_t Mask, int32_t C>
+inline float lookupFloat(const FloatLUTs& luts, float value) {
+    if constexpr (isCurved<Mask, C>()) {
+        return sampleLUTFloat(luts.data + luts.offset[C], luts.size[C], value);
+    } else {
+        return value;
+    }
+}
+
+#if defined(CURVE_KERNEL_AVX512)
+constexpr int32_t kLanes = 16;
+#elif defined(CURVE_KERNEL_AVX2)
+constexpr int32_t kLanes = 8;
+#endif
+
+template <int32_t Channels, uint32_t Mask>
+void applyLUTFloat(const KernelImage& image, const FloatLUTs& luts) {
+    const int32_t channels = Channels == 0 ? image.channels : Channels;
+    const int32_t row_samples = image.width * channels;
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    // Channels may use tables of different sizes, so lanes gather from the
+    // packed buffer with per-lane offsets. Lane parameters repeat every
+    // lcm(channels, kLanes) samples; a group of that many samples always
+    // ends on a pixel boundary.
+    constexpr int32_t lane_period = (Channels == 3) ? 3 : 1;
+    const int32_t group_samples = lane_period * kLanes;
+    #if defined(CURVE_KERNEL_AVX512)
+    uint32_t lane_mask[lane_period] = {};
+    #else
+    alignas(32) int32_t lane_mask[lane_period][kLanes];
+    #endif
+    alignas(64) int32_t lane_offset[lane_period][kLanes];
+    alignas(64) int32_t lane_max_index[lane_period][kLanes];
+    alignas(64) float lane_scale[lane_period][kLanes];
+    for (int32_t m = 0; m < lane_period; ++m) {
+        for (int32_t lane = 0; lane < kLanes; ++lane) {
+            int32_t c = (m * kLanes + lane) % channels;
+            bool curved = isCurved(Mask, c);
+            int32_t size = curved ? luts.size[c] : 2;
+            #if defined(CURVE_KERNEL_AVX512)
+            lane_mask[m] |= (curved ? 1u : 0u) << lane;
+            #else
+            lane_mask[m][lane] = curved ? -1 : 0;
+            #endif
+            lane_offset[m][lane] = curved ? luts.offset[c] : 0;
+            lane_max_index[m][lane] = size - 2;
+            lane_scale[m][lane] = static_cast<float>(size - 1);
+        }
+    }
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const float* src = reinterpret_cast<const float*>(srcRow(image, y));
+        float* dst = reinterpret_cast<float*>(dstRow(image, y));
+
+        if constexpr (Mask == 0) {
+            for (int32_t i = 0; i < row_samples; ++i) {
+                dst[i] = src[i];
+            }
+            continue;
+        }
+
+        int32_t i = 0;
+
+        #if defined(CURVE_KERNEL_AVX512)
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one = _mm512_set1_ps(1.0f);
+
+        for (; i + group_samples <= row_samples; ) {
+            for (int32_t m = 0; m < lane_period; ++m, i += kLanes) {
+                __m512 value = _mm512_loadu_ps(src + i);
+
+                // max(value, 0) maps NaN to 0, matching the scalar path
+                __m512 pos = _mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(value, zero), one),
+                                           _mm512_load_ps(lane_scale[m]));
+                __m512i index = _mm512_min_epi32(_mm512_cvttps_epi32(pos),
+                                                 _mm512_load_si512(lane_max_index[m]));
+                __m512 frac = _mm512_sub_ps(pos, _mm512_cvtepi32_ps(index));
+                index = _mm512_add_epi32(index, _mm512_load_si512(lane_offset[m]));
+
+                __m512 lo = _mm512_i32gather_ps(index, luts.data, 4);
+                __m512 hi = _mm512_i32gather_ps(index, luts.data + 1, 4);
+                __m512 result = _mm512_fmadd_ps(frac, _mm512_sub_ps(hi, lo), lo);
+
+                __mmask16 mask = static_cast<__mmask16>(lane_mask[m]);
+                _mm512_storeu_ps(dst + i, _mm512_mask_blend_ps(mask, value, result));
+            }
+        }
+        #elif defined(CURVE_KERNEL_AVX2)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        for (; i + group_samples <= row_samples; ) {
+            for (int32_t m = 0; m < lane_period; ++m, i += kLanes) {
+                __m256 value = _mm256_loadu_ps(src + i);
+
+                // max(value, 0) maps NaN to 0, matching the scalar path
+                __m256 pos = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(value, zero), one),
+                                           _mm256_load_ps(lane_scale[m]));
+                __m256i index = _mm256_min_epi32(
+                    _mm256_cvttps_epi32(pos),
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(lane_max_index[m])));
+                __m256 frac = _mm256_sub_ps(pos, _mm256_cvtepi32_ps(index));
+                index = _mm256_add_epi32(
+                    index, _mm256_load_si256(reinterpret_cast<const __m256i*>(lane_offset[m])));
+
+                __m256 lo = _mm256_i32gather_ps(luts.data, index, 4);
+                __m256 hi = _mm256_i32gather_ps(luts.data + 1, index, 4);
+                __m256 result = _mm256_fmadd_ps(frac, _mm256_sub_ps(hi, lo), lo);
+
+                __m256 mask = _mm256_castsi256_ps(
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(lane_mask[m])));
+                _mm256_storeu_ps(dst + i, _mm256_blendv_ps(value, result, mask));
+            }
+        }
+        #endif
+
+        if constexpr (Channels == 0) {
+            for (; i < row_samples; ++i) {
+                int32_t c = i % channels;
+                dst[i] = isCurved(Mask, c)
+                             ? sampleLUTFloat(luts.data + luts.offset[c], luts.size[c], src[i])
+                             : src[i];
+            }
+        } else {
+            for (; i < row_samples; i += Channels) {
+                dst[i + 0] = lookupFloat<Mask, 0>(luts, src[i + 0]);
+                dst[i + 1] = lookupFloat<Mask, 1>(luts, src[i + 1]);
+                dst[i + 2] = lookupFloat<Mask, 2>(luts, src[i + 2]);
+                if constexpr (Channels == 4) {
+                    dst[i + 3] = src[i + 3];
+                }
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Luminance-preserving lookup
+// =============================================================================
+
+// Branch-free forms shared by the scalar paths and the row tails
+inline int32_t maxOf(int32_t a, int32_t b) { return a > b ? a : b; }
+inline int32_t minOf(int32_t a, int32_t b) { return a < b ? a : b; }
+inline float maxOf(float a, float b) { return a > b ? a : b; }
+inline float minOf(float a, float b) { return a < b ? a : b; }
+
+inline uint16_t swapBytes(uint16_t value) {
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+// The vector paths work on blocks of kLanes pixels. The block's samples
+// are loaded as Channels vectors of one sample per lane; R, G and B are
+// split out into pixel lanes to compute gain and lift, which are then
+// spread back so lane l of sample vector m gets pixel (m * kLanes + l) / Channels.
+#if defined(CURVE_KERNEL_AVX512)
+using LaneVec = __m512i;
+
+template <int32_t Channels>
+inline void splitRGB(const LaneVec* samples, LaneVec* rgb) {
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                           8, 9, 10, 11, 12, 13, 14, 15);
+    for (int32_t c = 0; c < 3; ++c) {
+        // Sample index within the block; the permutes use its low bits
+        __m512i pos = _mm512_add_epi32(_mm512_mullo_epi32(lane, _mm512_set1_epi32(Channels)),
+                                       _mm512_set1_epi32(c));
+        __mmask16 upper = _mm512_cmpge_epi32_mask(pos, _mm512_set1_epi32(2 * kLanes));
+        __m512i lo = _mm512_permutex2var_epi32(samples[0], pos, samples[1]);
+        __m512i hi = Channels == 4 ? _mm512_permutex2var_epi32(samples[2], pos, samples[3])
+                                   : _mm512_permutexvar_epi32(pos, samples[2]);
+        rgb[c] = _mm512_mask_blend_epi32(upper, lo, hi);
+    }
+}
+#elif defined(CURVE_KERNEL_AVX2)
+using LaneVec = __m256i;
+
+template <int32_t Channels>
+inline void splitRGB(const LaneVec* samples, LaneVec* rgb) {
+    if constexpr (Channels == 3) {
+        // Each channel's samples sit in distinct lanes across the three
+        // vectors: blend them together, then put them in pixel order
+        rgb[0] = _mm256_blend_epi32(_mm256_blend_epi32(samples[0], samples[1], 0x92),
+                                    samples[2], 0x24);
+        rgb[1] = _mm256_blend_epi32(_mm256_blend_epi32(samples[0], samples[1], 0x24),
+                                    samples[2], 0x49);
+        rgb[2] = _mm256_blend_epi32(_mm256_blend_epi32(samples[0], samples[1], 0x49),
+                                    samples[2], 0x92);
+        rgb[0] = _mm256_permutevar8x32_epi32(rgb[0], _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        rgb[1] = _mm256_permutevar8x32_epi32(rgb[1], _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+        rgb[2] = _mm256_permutevar8x32_epi32(rgb[2], _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+    } else {
+        // 4x4 transpose per 128-bit half leaves pixels as 0 2 4 6 1 3 5 7
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        __m256i rg01 = _mm256_unpacklo_epi32(samples[0], samples[1]);
+        __m256i rg23 = _mm256_unpacklo_epi32(samples[2], samples[3]);
+        __m256i ba01 = _mm256_unpackhi_epi32(samples[0], samples[1]);
+        __m256i ba23 = _mm256_unpackhi_epi32(samples[2], samples[3]);
+        rgb[0] = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(rg01, rg23), order);
+        rgb[1] = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(rg01, rg23), order);
+        rgb[2] = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(ba01, ba23), order);
+    }
+}
+#endif
+
+#if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+/**
+ * Pixel lane and channel of every lane of a block's sample vectors
+ */
+template <int32_t Channels>
+struct BlockSpread {
+    alignas(64) int32_t index[Channels][kLanes];
+    alignas(64) int32_t channel[Channels][kLanes];
+
+    BlockSpread() {
+        for (int32_t m = 0; m < Channels; ++m) {
+            for (int32_t lane = 0; lane < kLanes; ++lane) {
+                index[m][lane] = (m * kLanes + lane) / Channels;
+                channel[m][lane] = (m * kLanes + lane) % Channels;
+            }
+        }
+    }
+};
+#endif
+
+template <int32_t Channels>
+void applyLuma8(const KernelImage& image, const LumaTables8& tables) {
+    constexpr int32_t round = 1 << (LUMA8_GAIN_BITS - 1);
+    const int32_t* gain_table = tables.gain;
+    const int32_t* limit_table = tables.limit;
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    const BlockSpread<Channels> spread;
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const uint8_t* src = srcRow(image, y);
+        uint8_t* dst = dstRow(image, y);
+        int32_t x = 0;
+
+        #if defined(CURVE_KERNEL_AVX512)
+        const __m512i black = _mm512_set1_epi32(tables.black);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const uint8_t* s = src + x * Channels;
+            uint8_t* d = dst + x * Channels;
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                samples[m] = _mm512_cvtepu8_epi32(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + m * kLanes)));
+            }
+            splitRGB<Channels>(samples, rgb);
+
+            __m512i luma = _mm512_add_epi32(
+                _mm512_add_epi32(_mm512_mullo_epi32(rgb[0], _mm512_set1_epi32(LUMA8_WEIGHTS[0])),
+                                 _mm512_mullo_epi32(rgb[1], _mm512_set1_epi32(LUMA8_WEIGHTS[1]))),
+                _mm512_add_epi32(_mm512_mullo_epi32(rgb[2], _mm512_set1_epi32(LUMA8_WEIGHTS[2])),
+                                 _mm512_set1_epi32(128)));
+            luma = _mm512_srli_epi32(luma, 8);
+            __m512i brightest = _mm512_max_epi32(rgb[0], _mm512_max_epi32(rgb[1], rgb[2]));
+            __m512i gain = _mm512_min_epi32(_mm512_i32gather_epi32(luma, gain_table, 4),
+                                            _mm512_i32gather_epi32(brightest, limit_table, 4));
+            __m512i lift = _mm512_maskz_mov_epi32(
+                _mm512_cmpeq_epi32_mask(luma, _mm512_setzero_si512()), black);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m512i index = _mm512_load_si512(spread.index[m]);
+                __m512i out = _mm512_mullo_epi32(samples[m], _mm512_permutexvar_epi32(index, gain));
+                out = _mm512_srai_epi32(_mm512_add_epi32(out, _mm512_set1_epi32(round)),
+                                        LUMA8_GAIN_BITS);
+                out = _mm512_add_epi32(out, _mm512_permutexvar_epi32(index, lift));
+                if constexpr (Channels == 4) {
+                    out = _mm512_mask_blend_epi32(0x8888, out, samples[m]);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + m * kLanes),
+                                 _mm512_cvtepi32_epi8(out));
+            }
+        }
+        #elif defined(CURVE_KERNEL_AVX2)
+        const __m256i black = _mm256_set1_epi32(tables.black);
+        // Low byte of every dword to the front of each 128-bit half, then
+        // both halves' first dwords together
+        const __m256i pack_bytes = _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m256i pack_halves = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const uint8_t* s = src + x * Channels;
+            uint8_t* d = dst + x * Channels;
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                samples[m] = _mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + m * kLanes)));
+            }
+            splitRGB<Channels>(samples, rgb);
+
+            __m256i luma = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_mullo_epi32(rgb[0], _mm256_set1_epi32(LUMA8_WEIGHTS[0])),
+                                 _mm256_mullo_epi32(rgb[1], _mm256_set1_epi32(LUMA8_WEIGHTS[1]))),
+                _mm256_add_epi32(_mm256_mullo_epi32(rgb[2], _mm256_set1_epi32(LUMA8_WEIGHTS[2])),
+                                 _mm256_set1_epi32(128)));
+            luma = _mm256_srli_epi32(luma, 8);
+            __m256i brightest = _mm256_max_epi32(rgb[0], _mm256_max_epi32(rgb[1], rgb[2]));
+            __m256i gain = _mm256_min_epi32(_mm256_i32gather_epi32(gain_table, luma, 4),
+                                            _mm256_i32gather_epi32(limit_table, brightest, 4));
+            __m256i lift = _mm256_and_si256(
+                _mm256_cmpeq_epi32(luma, _mm256_setzero_si256()), black);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m256i index =
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(spread.index[m]));
+                __m256i out =
+                    _mm256_mullo_epi32(samples[m], _mm256_permutevar8x32_epi32(gain, index));
+                out = _mm256_srai_epi32(_mm256_add_epi32(out, _mm256_set1_epi32(round)),
+                                        LUMA8_GAIN_BITS);
+                out = _mm256_add_epi32(out, _mm256_permutevar8x32_epi32(lift, index));
+                if constexpr (Channels == 4) {
+                    out = _mm256_blend_epi32(out, samples[m], 0x88);
+                }
+                out = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(out, pack_bytes),
+                                                  pack_halves);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(d + m * kLanes),
+                                 _mm256_castsi256_si128(out));
+            }
+        }
+        #endif
+
+        for (; x < image.width; ++x) {
+            const uint8_t* s = src + x * Channels;
+            uint8_t* d = dst + x * Channels;
+            int32_t r = s[0];
+            int32_t g = s[1];
+            int32_t b = s[2];
+
+            int32_t luma = (LUMA8_WEIGHTS[0] * r + LUMA8_WEIGHTS[1] * g +
+                            LUMA8_WEIGHTS[2] * b + 128) >> 8;
+            int32_t gain = minOf(gain_table[luma], limit_table[maxOf(r, maxOf(g, b))]);
+            int32_t lift = luma == 0 ? tables.black : 0;
+
+            d[0] = static_cast<uint8_t>(((r * gain + round) >> LUMA8_GAIN_BITS) + lift);
+            d[1] = static_cast<uint8_t>(((g * gain + round) >> LUMA8_GAIN_BITS) + lift);
+            d[2] = static_cast<uint8_t>(((b * gain + round) >> LUMA8_GAIN_BITS) + lift);
+            if constexpr (Channels == 4) {
+                d[3] = s[3];
+            }
+        }
+    }
+}
+
+template <int32_t Channels, bool Swapped>
+void applyLuma16(const KernelImage& image, const LumaTables16& tables) {
+    const float* gain_table = tables.gain;
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    const BlockSpread<Channels> spread;
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const uint16_t* src = reinterpret_cast<const uint16_t*>(srcRow(image, y));
+        uint16_t* dst = reinterpret_cast<uint16_t*>(dstRow(image, y));
+        int32_t x = 0;
+
+        #if defined(CURVE_KERNEL_AVX512)
+        const __m512 black = _mm512_set1_ps(tables.black);
+        const __m256i swap_bytes = _mm256_setr_epi8(
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const uint16_t* s = src + x * Channels;
+            uint16_t* d = dst + x * Channels;
+            __m256i raw[Channels];
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                raw[m] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + m * kLanes));
+                samples[m] = _mm512_cvtepu16_epi32(
+                    Swapped ? _mm256_shuffle_epi8(raw[m], swap_bytes) : raw[m]);
+            }
+            splitRGB<Channels>(samples, rgb);
+
+            // Unsigned: the weighted sum can exceed INT32_MAX
+            __m512i luma = _mm512_add_epi32(
+                _mm512_add_epi32(_mm512_mullo_epi32(rgb[0], _mm512_set1_epi32(LUMA16_WEIGHTS[0])),
+                                 _mm512_mullo_epi32(rgb[1], _mm512_set1_epi32(LUMA16_WEIGHTS[1]))),
+                _mm512_add_epi32(_mm512_mullo_epi32(rgb[2], _mm512_set1_epi32(LUMA16_WEIGHTS[2])),
+                                 _mm512_set1_epi32(32768)));
+            luma = _mm512_srli_epi32(luma, 16);
+            __m512 brightest =
+                _mm512_cvtepi32_ps(_mm512_max_epi32(rgb[0], _mm512_max_epi32(rgb[1], rgb[2])));
+            __m512 gain = _mm512_min_ps(_mm512_i32gather_ps(luma, gain_table, 4),
+                                        _mm512_div_ps(_mm512_set1_ps(65535.0f), brightest));
+            __m512 lift = _mm512_maskz_mov_ps(
+                _mm512_cmpeq_epi32_mask(luma, _mm512_setzero_si512()), black);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m512i index = _mm512_load_si512(spread.index[m]);
+                __m512 out = _mm512_fmadd_ps(_mm512_cvtepi32_ps(samples[m]),
+                                             _mm512_permutexvar_ps(index, gain),
+                                             _mm512_permutexvar_ps(index, lift));
+                out = _mm512_add_ps(out, _mm512_set1_ps(0.5f));
+                __m256i packed = _mm512_cvtepi32_epi16(_mm512_cvttps_epi32(out));
+                if constexpr (Swapped) {
+                    packed = _mm256_shuffle_epi8(packed, swap_bytes);
+                }
+                if constexpr (Channels == 4) {
+                    packed = _mm256_mask_blend_epi16(0x8888, packed, raw[m]);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + m * kLanes), packed);
+            }
+        }
+        #elif defined(CURVE_KERNEL_AVX2)
+        const __m256 black = _mm256_set1_ps(tables.black);
+        const __m128i swap_bytes =
+            _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const uint16_t* s = src + x * Channels;
+            uint16_t* d = dst + x * Channels;
+            __m128i raw[Channels];
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                raw[m] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + m * kLanes));
+                samples[m] = _mm256_cvtepu16_epi32(
+                    Swapped ? _mm_shuffle_epi8(raw[m], swap_bytes) : raw[m]);
+            }
+            splitRGB<Channels>(samples, rgb);
+
+            // Unsigned: the weighted sum can exceed INT32_MAX
+            __m256i luma = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_mullo_epi32(rgb[0], _mm256_set1_epi32(LUMA16_WEIGHTS[0])),
+                                 _mm256_mullo_epi32(rgb[1], _mm256_set1_epi32(LUMA16_WEIGHTS[1]))),
+                _mm256_add_epi32(_mm256_mullo_epi32(rgb[2], _mm256_set1_epi32(LUMA16_WEIGHTS[2])),
+                                 _mm256_set1_epi32(32768)));
+            luma = _mm256_srli_epi32(luma, 16);
+            __m256 brightest =
+                _mm256_cvtepi32_ps(_mm256_max_epi32(rgb[0], _mm256_max_epi32(rgb[1], rgb[2])));
+            __m256 gain = _mm256_min_ps(_mm256_i32gather_ps(gain_table, luma, 4),
+                                        _mm256_div_ps(_mm256_set1_ps(65535.0f), brightest));
+            __m256 lift = _mm256_and_ps(
+                _mm256_castsi256_ps(_mm256_cmpeq_epi32(luma, _mm256_setzero_si256())), black);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m256i index =
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(spread.index[m]));
+                __m256 out = _mm256_fmadd_ps(_mm256_cvtepi32_ps(samples[m]),
+                                             _mm256_permutevar8x32_ps(gain, index),
+                                             _mm256_permutevar8x32_ps(lift, index));
+                out = _mm256_add_ps(out, _mm256_set1_ps(0.5f));
+                __m256i words = _mm256_cvttps_epi32(out);
+                words = _mm256_permute4x64_epi64(_mm256_packus_epi32(words, words), 0x08);
+                __m128i packed = _mm256_castsi256_si128(words);
+                if constexpr (Swapped) {
+                    packed = _mm_shuffle_epi8(packed, swap_bytes);
+                }
+                if constexpr (Channels == 4) {
+                    packed = _mm_blend_epi16(packed, raw[m], 0x88);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(d + m * kLanes), packed);
+            }
+        }
+        #endif
+
+        for (; x < image.width; ++x) {
+            const uint16_t* s = src + x * Channels;
+            uint16_t* d = dst + x * Channels;
+            int32_t r = Swapped ? swapBytes(s[0]) : s[0];
+            int32_t g = Swapped ? swapBytes(s[1]) : s[1];
+            int32_t b = Swapped ? swapBytes(s[2]) : s[2];
+
+            int32_t luma = static_cast<int32_t>(
+                (static_cast<uint32_t>(LUMA16_WEIGHTS[0] * r) +
+                 static_cast<uint32_t>(LUMA16_WEIGHTS[1] * g) +
+                 static_cast<uint32_t>(LUMA16_WEIGHTS[2] * b) + 32768u) >> 16);
+            float brightest = static_cast<float>(maxOf(r, maxOf(g, b)));
+            float gain = minOf(gain_table[luma], 65535.0f / brightest);
+            float lift = luma == 0 ? tables.black : 0.0f;
+
+            uint16_t out_r = static_cast<uint16_t>(static_cast<float>(r) * gain + lift + 0.5f);
+            uint16_t out_g = static_cast<uint16_t>(static_cast<float>(g) * gain + lift + 0.5f);
+            uint16_t out_b = static_cast<uint16_t>(static_cast<float>(b) * gain + lift + 0.5f);
+            d[0] = Swapped ? swapBytes(out_r) : out_r;
+            d[1] = Swapped ? swapBytes(out_g) : out_g;
+            d[2] = Swapped ? swapBytes(out_b) : out_b;
+            if constexpr (Channels == 4) {
+                d[3] = s[3];
+            }
+        }
+    }
+}
+
+template <int32_t Channels>
+void applyLumaFloat(const KernelImage& image, const LumaFloat& lut) {
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    const BlockSpread<Channels> spread;
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const float* src = reinterpret_cast<const float*>(srcRow(image, y));
+        float* dst = reinterpret_cast<float*>(dstRow(image, y));
+        int32_t x = 0;
+
+        #if defined(CURVE_KERNEL_AVX512)
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512 scale = _mm512_set1_ps(static_cast<float>(lut.size - 1));
+        const __m512i max_index = _mm512_set1_epi32(lut.size - 2);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const float* s = src + x * Channels;
+            float* d = dst + x * Channels;
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                samples[m] = _mm512_castps_si512(_mm512_loadu_ps(s + m * kLanes));
+            }
+            splitRGB<Channels>(samples, rgb);
+            __m512 r = _mm512_castsi512_ps(rgb[0]);
+            __m512 g = _mm512_castsi512_ps(rgb[1]);
+            __m512 b = _mm512_castsi512_ps(rgb[2]);
+
+            __m512 luma = _mm512_fmadd_ps(_mm512_set1_ps(LUMA_WEIGHT_R), r,
+                          _mm512_fmadd_ps(_mm512_set1_ps(LUMA_WEIGHT_G), g,
+                                          _mm512_mul_ps(_mm512_set1_ps(LUMA_WEIGHT_B), b)));
+
+            // max(luma, 0) maps NaN to 0, matching sampleLUTFloat
+            __m512 pos = _mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(luma, zero), one), scale);
+            __m512i index = _mm512_min_epi32(_mm512_cvttps_epi32(pos), max_index);
+            __m512 frac = _mm512_sub_ps(pos, _mm512_cvtepi32_ps(index));
+            __m512 lo = _mm512_i32gather_ps(index, lut.lut, 4);
+            __m512 hi = _mm512_i32gather_ps(index, lut.lut + 1, 4);
+            __m512 mapped = _mm512_fmadd_ps(frac, _mm512_sub_ps(hi, lo), lo);
+
+            __mmask16 has_ratio = _mm512_cmp_ps_mask(luma, _mm512_set1_ps(1e-6f), _CMP_GT_OQ);
+            __m512 gain = _mm512_maskz_div_ps(has_ratio, mapped, luma);
+            __m512 lift = _mm512_mask_blend_ps(has_ratio, mapped, zero);
+            __m512 brightest = _mm512_max_ps(r, _mm512_max_ps(g, b));
+            __mmask16 capped =
+                _mm512_cmp_ps_mask(_mm512_mul_ps(brightest, gain), one, _CMP_GT_OQ);
+            gain = _mm512_mask_div_ps(gain, capped, one, brightest);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m512i index = _mm512_load_si512(spread.index[m]);
+                __m512 value = _mm512_castsi512_ps(samples[m]);
+                __m512 out = _mm512_fmadd_ps(value, _mm512_permutexvar_ps(index, gain),
+                                             _mm512_permutexvar_ps(index, lift));
+                if constexpr (Channels == 4) {
+                    out = _mm512_mask_blend_ps(0x8888, out, value);
+                }
+                _mm512_storeu_ps(d + m * kLanes, out);
+            }
+        }
+        #elif defined(CURVE_KERNEL_AVX2)
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 scale = _mm256_set1_ps(static_cast<float>(lut.size - 1));
+        const __m256i max_index = _mm256_set1_epi32(lut.size - 2);
+
+        for (; x + kLanes <= image.width; x += kLanes) {
+            const float* s = src + x * Channels;
+            float* d = dst + x * Channels;
+            LaneVec samples[Channels];
+            LaneVec rgb[3];
+            for (int32_t m = 0; m < Channels; ++m) {
+                samples[m] = _mm256_castps_si256(_mm256_loadu_ps(s + m * kLanes));
+            }
+            splitRGB<Channels>(samples, rgb);
+            __m256 r = _mm256_castsi256_ps(rgb[0]);
+            __m256 g = _mm256_castsi256_ps(rgb[1]);
+            __m256 b = _mm256_castsi256_ps(rgb[2]);
+
+            __m256 luma = _mm256_fmadd_ps(_mm256_set1_ps(LUMA_WEIGHT_R), r,
+                          _mm256_fmadd_ps(_mm256_set1_ps(LUMA_WEIGHT_G), g,
+                                          _mm256_mul_ps(_mm256_set1_ps(LUMA_WEIGHT_B), b)));
+
+            // max(luma, 0) maps NaN to 0, matching sampleLUTFloat
+            __m256 pos = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(luma, zero), one), scale);
+            __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(pos), max_index);
+            __m256 frac = _mm256_sub_ps(pos, _mm256_cvtepi32_ps(index));
+            __m256 lo = _mm256_i32gather_ps(lut.lut, index, 4);
+            __m256 hi = _mm256_i32gather_ps(lut.lut + 1, index, 4);
+            __m256 mapped = _mm256_fmadd_ps(frac, _mm256_sub_ps(hi, lo), lo);
+
+            __m256 has_ratio = _mm256_cmp_ps(luma, _mm256_set1_ps(1e-6f), _CMP_GT_OQ);
+            __m256 gain = _mm256_and_ps(has_ratio, _mm256_div_ps(mapped, luma));
+            __m256 lift = _mm256_andnot_ps(has_ratio, mapped);
+            __m256 brightest = _mm256_max_ps(r, _mm256_max_ps(g, b));
+            __m256 capped = _mm256_cmp_ps(_mm256_mul_ps(brightest, gain), one, _CMP_GT_OQ);
+            gain = _mm256_blendv_ps(gain, _mm256_div_ps(one, brightest), capped);
+
+            for (int32_t m = 0; m < Channels; ++m) {
+                __m256i index =
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(spread.index[m]));
+                __m256 value = _mm256_castsi256_ps(samples[m]);
+                __m256 out = _mm256_fmadd_ps(value, _mm256_permutevar8x32_ps(gain, index),
+                                             _mm256_permutevar8x32_ps(lift, index));
+                if constexpr (Channels == 4) {
+                    out = _mm256_blend_ps(out, value, 0x88);
+                }
+                _mm256_storeu_ps(d + m * kLanes, out);
+            }
+        }
+        #endif
+
+        for (; x < image.width; ++x) {
+            const float* s = src + x * Channels;
+            float* d = dst + x * Channels;
+            float r = s[0];
+            float g = s[1];
+            float b = s[2];
+
+            float luma = LUMA_WEIGHT_R * r + LUMA_WEIGHT_G * g + LUMA_WEIGHT_B * b;
+            float mapped = sampleLUTFloat(lut.lut, lut.size, luma);
+            bool has_ratio = luma > 1e-6f;
+            float gain = has_ratio ? mapped / luma : 0.0f;
+            float lift = has_ratio ? 0.0f : mapped;
+
+            // Same white cap as the integer formats: the curve domain ends at 1
+            float brightest = maxOf(r, maxOf(g, b));
+            gain = brightest * gain > 1.0f ? 1.0f / brightest : gain;
+
+            d[0] = r * gain + lift;
+            d[1] = g * gain + lift;
+            d[2] = b * gain + lift;
+            if constexpr (Channels == 4) {
+                d[3] = s[3];
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Lab channel curves
+// =============================================================================
+
+constexpr float LAB_DELTA = 6.0f / 29.0f;
+constexpr float LAB_LINEAR_SLOPE = 3.0f * LAB_DELTA * LAB_DELTA;
+constexpr float LAB_KNEE = LAB_DELTA * LAB_DELTA * LAB_DELTA;
+
+// The float bits of t^(-1/3) are roughly this minus a third of t's bits
+constexpr int32_t LAB_CBRT_SEED = 0x54a21000;
+
+inline int32_t floatBits(float value) {
+    int32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(int32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Lab companding f(t): cube root above the knee, linear below
+ * The cube root is t * r * r with r = t^(-1/3) from the bit-level seed and
+ * division-free Newton steps; two steps are within 3e-5, three 6e-7.
+ * Arithmetic beats a table here: interpolating one costs two gathers.
+ */
+template <int32_t Steps>
+inline float labF(float t) {
+    if (!(t > LAB_KNEE)) {
+        return t * (1.0f / LAB_LINEAR_SLOPE) + 4.0f / 29.0f;
+    }
+    float r = bitsFloat(LAB_CBRT_SEED -
+                        static_cast<int32_t>(static_cast<float>(floatBits(t)) * (1.0f / 3.0f)));
+    float third = t * (1.0f / 3.0f);
+    for (int32_t i = 0; i < Steps; ++i) {
+        r = r * (4.0f / 3.0f - third * (r * r * r));
+    }
+    return t * r * r;
+}
+
+inline float labFInverse(float f) {
+    return f > LAB_DELTA ? f * f * f : LAB_LINEAR_SLOPE * (f - 4.0f / 29.0f);
+}
+
+/**
+ * Lab round trip of one linear RGB pixel, the reference for the vector paths
+ * Works on f(Y) and the a / b offsets from it, so a component without a
+ * curve comes back as it went in.
+ */
+template <int32_t Steps>
+inline void labPixel(const LabCurves& curves, float rgb[3]) {
+    float f[3];
+    for (int32_t i = 0; i < 3; ++i) {
+        f[i] = labF<Steps>(LAB_RGB_TO_XYZ[i][0] * rgb[0] + LAB_RGB_TO_XYZ[i][1] * rgb[1] +
+                           LAB_RGB_TO_XYZ[i][2] * rgb[2]);
+    }
+
+    float fl = f[1];
+    float da = f[0] - f[1];   // a / 500
+    float db = f[1] - f[2];   // b / 200
+    if (curves.lut[0]) {
+        float l = sampleLUTFloat(curves.lut[0], curves.size[0], 1.16f * fl - 0.16f);
+        fl = l * (100.0f / 116.0f) + 16.0f / 116.0f;
+    }
+    if (curves.lut[1]) {
+        float a = sampleLUTFloat(curves.lut[1], curves.size[1],
+                                 da * (500.0f / 255.0f) + 128.0f / 255.0f);
+        da = a * (255.0f / 500.0f) - 128.0f / 500.0f;
+    }
+    if (curves.lut[2]) {
+        float b = sampleLUTFloat(curves.lut[2], curves.size[2],
+                                 db * (200.0f / 255.0f) + 128.0f / 255.0f);
+        db = b * (255.0f / 200.0f) - 128.0f / 200.0f;
+    }
+
+    float xyz[3] = {labFInverse(fl + da), labFInverse(fl), labFInverse(fl - db)};
+    for (int32_t i = 0; i < 3; ++i) {
+        rgb[i] = LAB_XYZ_TO_RGB[i][0] * xyz[0] + LAB_XYZ_TO_RGB[i][1] * xyz[1] +
+                 LAB_XYZ_TO_RGB[i][2] * xyz[2];
+    }
+}
+
+// Integer samples are sRGB codes, float samples linear light
+template <typename T, bool Swapped>
+inline float labDecode(const LabCurves& curves, T value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return value;
+    } else if constexpr (Swapped) {
+        return curves.decode[swapBytes(value)];
+    } else {
+        return curves.decode[value];
+    }
+}
+
+template <typename T, bool Swapped>
+inline T labEncode(const LabCurves& curves, float value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    } else if constexpr (sizeof(T) == 1) {
+        // Negative values and NaN clamp through their bit patterns
+        int32_t bits = floatBits(value);
+        bits = bits > SRGB_ENCODE8_MIN_BITS ? bits : SRGB_ENCODE8_MIN_BITS;
+        bits = bits < SRGB_ENCODE8_MAX_BITS ? bits : SRGB_ENCODE8_MAX_BITS;
+        uint32_t entry = curves.encode8[(bits - SRGB_ENCODE8_MIN_BITS) >> 20];
+        uint32_t t = (static_cast<uint32_t>(bits) >> 12) & 0xff;
+        return static_cast<T>(((entry >> 16 << 9) + (entry & 0xffff) * t) >> 16);
+    } else {
+        T code = static_cast<T>(
+            sampleLUTFloat(curves.encode, SRGB_ENCODE_SIZE, value) * 65535.0f + 0.5f);
+        if constexpr (Swapped) {
+            return swapBytes(code);
+        } else {
+            return code;
+        }
+    }
+}
+
+#if defined(CURVE_KERNEL_AVX512)
+using LaneVecF = __m512;
+
+template <typename T, bool Swapped>
+inline LaneVec loadLanes(const T* at) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at)));
+    } else if constexpr (sizeof(T) == 2) {
+        __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+        if constexpr (Swapped) {
+            raw = _mm256_shuffle_epi8(raw, _mm256_setr_epi8(
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+        return _mm512_cvtepu16_epi32(raw);
+    } else {
+        return _mm512_castps_si512(_mm512_loadu_ps(at));
+    }
+}
+
+template <typename T, bool Swapped>
+inline void storeLanes(T* at, LaneVec value) {
+    if constexpr (sizeof(T) == 1) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(at), _mm512_cvtepi32_epi8(value));
+    } else if constexpr (sizeof(T) == 2) {
+        __m256i packed = _mm512_cvtepi32_epi16(value);
+        if constexpr (Swapped) {
+            packed = _mm256_shuffle_epi8(packed, _mm256_setr_epi8(
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(at), packed);
+    } else {
+        _mm512_storeu_ps(at, _mm512_castsi512_ps(value));
+    }
+}
+
+/**
+ * Inverse of splitRGB: write pixel-lane R, G and B back into the block's
+ * sample vectors, leaving alpha lanes as they are
+ */
+template <int32_t Channels>
+inline void mergeRGB(const LaneVec* rgb, const BlockSpread<Channels>& spread, LaneVec* samples) {
+    for (int32_t m = 0; m < Channels; ++m) {
+        __m512i pixel = _mm512_load_si512(spread.index[m]);
+        __m512i channel = _mm512_load_si512(spread.channel[m]);
+        __mmask16 green = _mm512_cmpeq_epi32_mask(channel, _mm512_set1_epi32(1));
+        __mmask16 blue = _mm512_cmpeq_epi32_mask(channel, _mm512_set1_epi32(2));
+        __mmask16 colour = _mm512_cmplt_epi32_mask(channel, _mm512_set1_epi32(3));
+        // Index bit 4 picks G over R in the two-source permute
+        __m512i rg_index = _mm512_mask_add_epi32(pixel, green, pixel, _mm512_set1_epi32(kLanes));
+        __m512i merged = _mm512_mask_blend_epi32(
+            blue, _mm512_permutex2var_epi32(rgb[0], rg_index, rgb[1]),
+            _mm512_permutexvar_epi32(pixel, rgb[2]));
+        samples[m] = _mm512_mask_blend_epi32(colour, samples[m], merged);
+    }
+}
+
+inline LaneVecF sampleLanes(const float* table, int32_t size, LaneVecF value) {
+    // max(value, 0) maps NaN to 0, matching sampleLUTFloat
+    __m512 pos = _mm512_mul_ps(
+        _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()), _mm512_set1_ps(1.0f)),
+        _mm512_set1_ps(static_cast<float>(size - 1)));
+    __m512i index = _mm512_min_epi32(_mm512_cvttps_epi32(pos), _mm512_set1_epi32(size - 2));
+    __m512 frac = _mm512_sub_ps(pos, _mm512_cvtepi32_ps(index));
+    __m512 lo = _mm512_i32gather_ps(index, table, 4);
+    __m512 hi = _mm512_i32gather_ps(index, table + 1, 4);
+    return _mm512_fmadd_ps(frac, _mm512_sub_ps(hi, lo), lo);
+}
+
+template <int32_t Steps>
+inline LaneVecF labFLanes(LaneVecF t) {
+    const __m512 knee = _mm512_set1_ps(LAB_KNEE);
+    __m512 c = _mm512_max_ps(t, knee);
+    __m512 third = _mm512_mul_ps(c, _mm512_set1_ps(1.0f / 3.0f));
+    __m512i bits = _mm512_cvttps_epi32(_mm512_mul_ps(
+        _mm512_cvtepi32_ps(_mm512_castps_si512(c)), _mm512_set1_ps(1.0f / 3.0f)));
+    __m512 r = _mm512_castsi512_ps(_mm512_sub_epi32(_mm512_set1_epi32(LAB_CBRT_SEED), bits));
+    for (int32_t i = 0; i < Steps; ++i) {
+        __m512 cube = _mm512_mul_ps(_mm512_mul_ps(r, r), r);
+        r = _mm512_mul_ps(r, _mm512_fnmadd_ps(third, cube, _mm512_set1_ps(4.0f / 3.0f)));
+    }
+    __m512 cube = _mm512_mul_ps(_mm512_mul_ps(c, r), r);
+    __m512 linear = _mm512_fmadd_ps(t, _mm512_set1_ps(1.0f / LAB_LINEAR_SLOPE),
+                                    _mm512_set1_ps(4.0f / 29.0f));
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(t, knee, _CMP_GT_OQ), linear, cube);
+}
+
+inline LaneVecF labFInverseLanes(LaneVecF f) {
+    __m512 cube = _mm512_mul_ps(_mm512_mul_ps(f, f), f);
+    __m512 linear = _mm512_mul_ps(_mm512_set1_ps(LAB_LINEAR_SLOPE),
+                                  _mm512_sub_ps(f, _mm512_set1_ps(4.0f / 29.0f)));
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(f, _mm512_set1_ps(LAB_DELTA), _CMP_GT_OQ),
+                                linear, cube);
+}
+
+inline LaneVecF mulAdd(LaneVecF a, float b, float c) {
+    return _mm512_fmadd_ps(a, _mm512_set1_ps(b), _mm512_set1_ps(c));
+}
+
+inline LaneVecF addLanes(LaneVecF a, LaneVecF b) { return _mm512_add_ps(a, b); }
+inline LaneVecF subLanes(LaneVecF a, LaneVecF b) { return _mm512_sub_ps(a, b); }
+
+inline LaneVecF matrixRow(const float row[3], const LaneVecF* v) {
+    return _mm512_fmadd_ps(_mm512_set1_ps(row[0]), v[0],
+           _mm512_fmadd_ps(_mm512_set1_ps(row[1]), v[1],
+                           _mm512_mul_ps(_mm512_set1_ps(row[2]), v[2])));
+}
+
+template <typename T>
+inline LaneVecF labDecodeLanes(const LabCurves& curves, LaneVec value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm512_castsi512_ps(value);
+    } else {
+        return _mm512_i32gather_ps(value, curves.decode, 4);
+    }
+}
+
+template <typename T>
+inline LaneVec labEncodeLanes(const LabCurves& curves, LaneVecF value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        value = _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()), _mm512_set1_ps(1.0f));
+        return _mm512_castps_si512(value);
+    } else if constexpr (sizeof(T) == 1) {
+        __m512i bits = _mm512_min_epi32(
+            _mm512_max_epi32(_mm512_castps_si512(value), _mm512_set1_epi32(SRGB_ENCODE8_MIN_BITS)),
+            _mm512_set1_epi32(SRGB_ENCODE8_MAX_BITS));
+        __m512i bucket = _mm512_srli_epi32(
+            _mm512_sub_epi32(bits, _mm512_set1_epi32(SRGB_ENCODE8_MIN_BITS)), 20);
+        __m512i entry = _mm512_i32gather_epi32(bucket, curves.encode8, 4);
+        __m512i bias = _mm512_slli_epi32(_mm512_srli_epi32(entry, 16), 9);
+        __m512i scale = _mm512_and_si512(entry, _mm512_set1_epi32(0xffff));
+        __m512i t = _mm512_and_si512(_mm512_srli_epi32(bits, 12), _mm512_set1_epi32(0xff));
+        return _mm512_srli_epi32(_mm512_add_epi32(bias, _mm512_mullo_epi32(scale, t)), 16);
+    } else {
+        LaneVecF code = sampleLanes(curves.encode, SRGB_ENCODE_SIZE, value);
+        return _mm512_cvttps_epi32(mulAdd(code, 65535.0f, 0.5f));
+    }
+}
+#elif defined(CURVE_KERNEL_AVX2)
+using LaneVecF = __m256;
+
+template <typename T, bool Swapped>
+inline LaneVec loadLanes(const T* at) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(at)));
+    } else if constexpr (sizeof(T) == 2) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+        if constexpr (Swapped) {
+            raw = _mm_shuffle_epi8(
+                raw, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+        return _mm256_cvtepu16_epi32(raw);
+    } else {
+        return _mm256_castps_si256(_mm256_loadu_ps(at));
+    }
+}
+
+template <typename T, bool Swapped>
+inline void storeLanes(T* at, LaneVec value) {
+    if constexpr (sizeof(T) == 1) {
+        // Low byte of every dword to the front of each 128-bit half, then
+        // both halves' first dwords together
+        __m256i bytes = _mm256_shuffle_epi8(value, _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(at), _mm256_castsi256_si128(bytes));
+    } else if constexpr (sizeof(T) == 2) {
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(value, value), 0x08);
+        __m128i packed = _mm256_castsi256_si128(words);
+        if constexpr (Swapped) {
+            packed = _mm_shuffle_epi8(
+                packed, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(at), packed);
+    } else {
+        _mm256_storeu_ps(at, _mm256_castsi256_ps(value));
+    }
+}
+
+/**
+ * Inverse of splitRGB: write pixel-lane R, G and B back into the block's
+ * sample vectors, leaving alpha lanes as they are
+ */
+template <int32_t Channels>
+inline void mergeRGB(const LaneVec* rgb, const BlockSpread<Channels>&, LaneVec* samples) {
+    if constexpr (Channels == 3) {
+        // Undo the pixel-order permutes, then blend each channel's lanes in
+        __m256i r = _mm256_permutevar8x32_epi32(rgb[0], _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        __m256i g = _mm256_permutevar8x32_epi32(rgb[1], _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+        __m256i b = _mm256_permutevar8x32_epi32(rgb[2], _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+        samples[0] = _mm256_blend_epi32(_mm256_blend_epi32(r, g, 0x92), b, 0x24);
+        samples[1] = _mm256_blend_epi32(_mm256_blend_epi32(r, g, 0x24), b, 0x49);
+        samples[2] = _mm256_blend_epi32(_mm256_blend_epi32(r, g, 0x49), b, 0x92);
+    } else {
+        // Back to the transposed order 0 2 4 6 1 3 5 7, then the same 4x4
+        // transpose; alpha lanes are restored from the originals
+        const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        __m256i r = _mm256_permutevar8x32_epi32(rgb[0], order);
+        __m256i g = _mm256_permutevar8x32_epi32(rgb[1], order);
+        __m256i b = _mm256_permutevar8x32_epi32(rgb[2], order);
+        __m256i rg_lo = _mm256_unpacklo_epi32(r, g);
+        __m256i rg_hi = _mm256_unpackhi_epi32(r, g);
+        __m256i bb_lo = _mm256_unpacklo_epi32(b, b);
+        __m256i bb_hi = _mm256_unpackhi_epi32(b, b);
+        samples[0] = _mm256_blend_epi32(_mm256_unpacklo_epi64(rg_lo, bb_lo), samples[0], 0x88);
+        samples[1] = _mm256_blend_epi32(_mm256_unpackhi_epi64(rg_lo, bb_lo), samples[1], 0x88);
+        samples[2] = _mm256_blend_epi32(_mm256_unpacklo_epi64(rg_hi, bb_hi), samples[2], 0x88);
+        samples[3] = _mm256_blend_epi32(_mm256_unpackhi_epi64(rg_hi, bb_hi), samples[3], 0x88);
+    }
+}
+
+inline LaneVecF sampleLanes(const float* table, int32_t size, LaneVecF value) {
+    // max(value, 0) maps NaN to 0, matching sampleLUTFloat
+    __m256 pos = _mm256_mul_ps(
+        _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)),
+        _mm256_set1_ps(static_cast<float>(size - 1)));
+    __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(pos), _mm256_set1_epi32(size - 2));
+    __m256 frac = _mm256_sub_ps(pos, _mm256_cvtepi32_ps(index));
+    __m256 lo = _mm256_i32gather_ps(table, index, 4);
+    __m256 hi = _mm256_i32gather_ps(table + 1, index, 4);
+    return _mm256_fmadd_ps(frac, _mm256_sub_ps(hi, lo), lo);
+}
+
+template <int32_t Steps>
+inline LaneVecF labFLanes(LaneVecF t) {
+    const __m256 knee = _mm256_set1_ps(LAB_KNEE);
+    __m256 c = _mm256_max_ps(t, knee);
+    __m256 third = _mm256_mul_ps(c, _mm256_set1_ps(1.0f / 3.0f));
+    __m256i bits = _mm256_cvttps_epi32(_mm256_mul_ps(
+        _mm256_cvtepi32_ps(_mm256_castps_si256(c)), _mm256_set1_ps(1.0f / 3.0f)));
+    __m256 r = _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_set1_epi32(LAB_CBRT_SEED), bits));
+    for (int32_t i = 0; i < Steps; ++i) {
+        __m256 cube = _mm256_mul_ps(_mm256_mul_ps(r, r), r);
+        r = _mm256_mul_ps(r, _mm256_fnmadd_ps(third, cube, _mm256_set1_ps(4.0f / 3.0f)));
+    }
+    __m256 cube = _mm256_mul_ps(_mm256_mul_ps(c, r), r);
+    __m256 linear = _mm256_fmadd_ps(t, _mm256_set1_ps(1.0f / LAB_LINEAR_SLOPE),
+                                    _mm256_set1_ps(4.0f / 29.0f));
+    return _mm256_blendv_ps(linear, cube, _mm256_cmp_ps(t, knee, _CMP_GT_OQ));
+}
+
+inline LaneVecF labFInverseLanes(LaneVecF f) {
+    __m256 cube = _mm256_mul_ps(_mm256_mul_ps(f, f), f);
+    __m256 linear = _mm256_mul_ps(_mm256_set1_ps(LAB_LINEAR_SLOPE),
+                                  _mm256_sub_ps(f, _mm256_set1_ps(4.0f / 29.0f)));
+    return _mm256_blendv_ps(linear, cube,
+                            _mm256_cmp_ps(f, _mm256_set1_ps(LAB_DELTA), _CMP_GT_OQ));
+}
+
+inline LaneVecF mulAdd(LaneVecF a, float b, float c) {
+    return _mm256_fmadd_ps(a, _mm256_set1_ps(b), _mm256_set1_ps(c));
+}
+
+inline LaneVecF addLanes(LaneVecF a, LaneVecF b) { return _mm256_add_ps(a, b); }
+inline LaneVecF subLanes(LaneVecF a, LaneVecF b) { return _mm256_sub_ps(a, b); }
+
+inline LaneVecF matrixRow(const float row[3], const LaneVecF* v) {
+    return _mm256_fmadd_ps(_mm256_set1_ps(row[0]), v[0],
+           _mm256_fmadd_ps(_mm256_set1_ps(row[1]), v[1],
+                           _mm256_mul_ps(_mm256_set1_ps(row[2]), v[2])));
+}
+
+template <typename T>
+inline LaneVecF labDecodeLanes(const LabCurves& curves, LaneVec value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm256_castsi256_ps(value);
+    } else {
+        return _mm256_i32gather_ps(curves.decode, value, 4);
+    }
+}
+
+template <typename T>
+inline LaneVec labEncodeLanes(const LabCurves& curves, LaneVecF value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        return _mm256_castps_si256(value);
+    } else if constexpr (sizeof(T) == 1) {
+        __m256i bits = _mm256_min_epi32(
+            _mm256_max_epi32(_mm256_castps_si256(value), _mm256_set1_epi32(SRGB_ENCODE8_MIN_BITS)),
+            _mm256_set1_epi32(SRGB_ENCODE8_MAX_BITS));
+        __m256i bucket = _mm256_srli_epi32(
+            _mm256_sub_epi32(bits, _mm256_set1_epi32(SRGB_ENCODE8_MIN_BITS)), 20);
+        __m256i entry = _mm256_i32gather_epi32(
+            reinterpret_cast<const int*>(curves.encode8), bucket, 4);
+        __m256i bias = _mm256_slli_epi32(_mm256_srli_epi32(entry, 16), 9);
+        __m256i scale = _mm256_and_si256(entry, _mm256_set1_epi32(0xffff));
+        __m256i t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), _mm256_set1_epi32(0xff));
+        return _mm256_srli_epi32(_mm256_add_epi32(bias, _mm256_mullo_epi32(scale, t)), 16);
+    } else {
+        LaneVecF code = sampleLanes(curves.encode, SRGB_ENCODE_SIZE, value);
+        return _mm256_cvttps_epi32(mulAdd(code, 65535.0f, 0.5f));
+    }
+}
+#endif
+
+#if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+/**
+ * labPixel for Blocks blocks of pixel lanes, rgb[block * 3 + channel]
+ * Each step runs across all blocks before the next, so the gathers of
+ * independent blocks overlap instead of forming one long dependency chain.
+ */
+template <int32_t Steps, int32_t Blocks>
+inline void labLanes(const LabCurves& curves, LaneVecF* rgb) {
+    LaneVecF fl[Blocks];
+    LaneVecF da[Blocks];
+    LaneVecF db[Blocks];
+    for (int32_t k = 0; k < Blocks; ++k) {
+        LaneVecF f[3];
+        for (int32_t i = 0; i < 3; ++i) {
+            f[i] = labFLanes<Steps>(matrixRow(LAB_RGB_TO_XYZ[i], rgb + k * 3));
+        }
+        fl[k] = f[1];
+        da[k] = subLanes(f[0], f[1]);
+        db[k] = subLanes(f[1], f[2]);
+    }
+
+    if (curves.lut[0]) {
+        for (int32_t k = 0; k < Blocks; ++k) {
+            LaneVecF l = sampleLanes(curves.lut[0], curves.size[0], mulAdd(fl[k], 1.16f, -0.16f));
+            fl[k] = mulAdd(l, 100.0f / 116.0f, 16.0f / 116.0f);
+        }
+    }
+    if (curves.lut[1]) {
+        for (int32_t k = 0; k < Blocks; ++k) {
+            LaneVecF a = sampleLanes(curves.lut[1], curves.size[1],
+                                     mulAdd(da[k], 500.0f / 255.0f, 128.0f / 255.0f));
+            da[k] = mulAdd(a, 255.0f / 500.0f, -128.0f / 500.0f);
+        }
+    }
+    if (curves.lut[2]) {
+        for (int32_t k = 0; k < Blocks; ++k) {
+            LaneVecF b = sampleLanes(curves.lut[2], curves.size[2],
+                                     mulAdd(db[k], 200.0f / 255.0f, 128.0f / 255.0f));
+            db[k] = mulAdd(b, 255.0f / 200.0f, -128.0f / 200.0f);
+        }
+    }
+
+    for (int32_t k = 0; k < Blocks; ++k) {
+        LaneVecF xyz[3] = {labFInverseLanes(addLanes(fl[k], da[k])), labFInverseLanes(fl[k]),
+                           labFInverseLanes(subLanes(fl[k], db[k]))};
+        for (int32_t i = 0; i < 3; ++i) {
+            rgb[k * 3 + i] = matrixRow(LAB_XYZ_TO_RGB[i], xyz);
+        }
+    }
+}
+
+#endif
+
+// =============================================================================
+// Whole-pixel RGB operations (Lab, 3D LUT)
+// =============================================================================
+
+// An Op maps a pixel's R, G and B together. It provides decode / encode
+// between stored samples and floats, pixel() for one pixel and, on AVX2 /
+// AVX-512, decodeLanes / encodeLanes and lanes<Blocks>() for blocks of
+// pixel lanes, rgb[block * 3 + channel].
+
+#if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+/**
+ * Run op over Blocks consecutive blocks of pixels starting at s, into d
+ * The blocks go through op.lanes together, so the gathers of independent
+ * blocks overlap instead of forming one long dependency chain.
+ */
+template <typename T, int32_t Channels, bool Swapped, int32_t Blocks, typename Op>
+inline void rgbBlocks(const Op& op, const BlockSpread<Channels>& spread, const T* s, T* d) {
+    LaneVec samples[Blocks][Channels];
+    LaneVecF rgb[Blocks * 3];
+    for (int32_t k = 0; k < Blocks; ++k) {
+        LaneVec split[3];
+        for (int32_t m = 0; m < Channels; ++m) {
+            samples[k][m] = loadLanes<T, Swapped>(s + (k * Channels + m) * kLanes);
+        }
+        splitRGB<Channels>(samples[k], split);
+        for (int32_t c = 0; c < 3; ++c) {
+            rgb[k * 3 + c] = op.decodeLanes(split[c]);
+        }
+    }
+
+    op.template lanes<Blocks>(rgb);
+
+    for (int32_t k = 0; k < Blocks; ++k) {
+        LaneVec split[3];
+        for (int32_t c = 0; c < 3; ++c) {
+            split[c] = op.encodeLanes(rgb[k * 3 + c]);
+        }
+        mergeRGB<Channels>(split, spread, samples[k]);
+        for (int32_t m = 0; m < Channels; ++m) {
+            storeLanes<T, Swapped>(d + (k * Channels + m) * kLanes, samples[k][m]);
+        }
+    }
+}
+#endif
+
+/**
+ * Row loop for an Op: pairs of blocks, a single block, then a scalar tail;
+ * alpha is copied through
+ */
+template <typename T, int32_t Channels, bool Swapped, typename Op>
+void applyRGBOp(const KernelImage& image, const Op& op) {
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    const BlockSpread<Channels> spread;
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const T* src = reinterpret_cast<const T*>(srcRow(image, y));
+        T* dst = reinterpret_cast<T*>(dstRow(image, y));
+        int32_t x = 0;
+
+        #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+        for (; x + 2 * kLanes <= image.width; x += 2 * kLanes) {
+            rgbBlocks<T, Channels, Swapped, 2>(op, spread, src + x * Channels, dst + x * Channels);
+        }
+        for (; x + kLanes <= image.width; x += kLanes) {
+            rgbBlocks<T, Channels, Swapped, 1>(op, spread, src + x * Channels, dst + x * Channels);
+        }
+        #endif
+
+        for (; x < image.width; ++x) {
+            const T* s = src + x * Channels;
+            T* d = dst + x * Channels;
+            float rgb[3] = {op.decode(s[0]), op.decode(s[1]), op.decode(s[2])};
+
+            op.pixel(rgb);
+
+            d[0] = op.encode(rgb[0]);
+            d[1] = op.encode(rgb[1]);
+            d[2] = op.encode(rgb[2]);
+            if constexpr (Channels == 4) {
+                d[3] = s[3];
+            }
+        }
+    }
+}
+
+template <typename T, bool Swapped>
+struct LabOp {
+    // 8-bit output cannot see the last cube root step
+    static constexpr int32_t Steps = sizeof(T) == 1 ? 2 : 3;
+
+    const LabCurves& curves;
+
+    float decode(T value) const { return labDecode<T, Swapped>(curves, value); }
+    T encode(float value) const { return labEncode<T, Swapped>(curves, value); }
+    void pixel(float rgb[3]) const { labPixel<Steps>(curves, rgb); }
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    LaneVecF decodeLanes(LaneVec value) const { return labDecodeLanes<T>(curves, value); }
+    LaneVec encodeLanes(LaneVecF value) const { return labEncodeLanes<T>(curves, value); }
+
+    template <int32_t Blocks>
+    void lanes(LaneVecF* rgb) const { labLanes<Steps, Blocks>(curves, rgb); }
+    #endif
+};
+
+template <int32_t Channels>
+void applyLab8(const KernelImage& image, const LabCurves& curves) {
+    applyRGBOp<uint8_t, Channels, false>(image, LabOp<uint8_t, false>{curves});
+}
+
+template <int32_t Channels, bool Swapped>
+void applyLab16(const KernelImage& image, const LabCurves& curves) {
+    applyRGBOp<uint16_t, Channels, Swapped>(image, LabOp<uint16_t, Swapped>{curves});
+}
+
+template <int32_t Channels>
+void applyLabFloat(const KernelImage& image, const LabCurves& curves) {
+    applyRGBOp<float, Channels, false>(image, LabOp<float, false>{curves});
+}
+
+// =============================================================================
+// 3D LUTs
+// =============================================================================
+
+/**
+ * Tetrahedral interpolation of one pixel, the reference for the vector paths
+ * The cell is split by the order of the fractions: from the base node, one
+ * step along the axis with the largest fraction, then along the middle
+ * one, then to the far corner. The weights are the gaps between the sorted
+ * fractions.
+ */
+// Axis with the largest and smallest fraction, indexed by the comparisons
+// r >= g | r >= b << 1 | g >= b << 2
+constexpr int32_t kTetraFirst[8] = {2, 2, 2, 0, 1, 1, 1, 0};
+constexpr int32_t kTetraLast[8] = {0, 1, 0, 1, 0, 1, 2, 2};
+
+inline void lut3dPixel(const Lut3DTable& lut, float rgb[3]) {
+    const int32_t stride[3] = {3, 3 * lut.size, 3 * lut.size * lut.size};
+    const float last_node = static_cast<float>(lut.size - 1);
+    float frac[3];
+    int32_t base = 0;
+    for (int32_t c = 0; c < 3; ++c) {
+        float pos = rgb[c] * lut.scale[c] + lut.offset[c];
+        pos = pos > 0.0f ? (pos < last_node ? pos : last_node) : 0.0f;
+        int32_t index = static_cast<int32_t>(pos);
+        if (index > lut.size - 2) index = lut.size - 2;
+        frac[c] = pos - static_cast<float>(index);
+        base += index * stride[c];
+    }
+
+    // Ties may go either way as long as the first and last axes differ.
+    // The tetrahedron comes from a table: branches on the fraction order
+    // mispredict constantly on noisy images.
+    int32_t r_ge_g = frac[0] >= frac[1];
+    int32_t r_ge_b = frac[0] >= frac[2];
+    int32_t g_ge_b = frac[1] >= frac[2];
+    int32_t order = r_ge_g | (r_ge_b << 1) | (g_ge_b << 2);
+    int32_t first = kTetraFirst[order];
+    int32_t last = kTetraLast[order];
+    float hi = frac[first];
+    float lo = frac[last];
+    float mid = frac[3 - first - last];
+
+    int32_t far = base + stride[0] + stride[1] + stride[2];
+    const float* v0 = lut.data + base;
+    const float* v1 = lut.data + base + stride[first];
+    const float* v2 = lut.data + far - stride[last];
+    const float* v3 = lut.data + far;
+    for (int32_t c = 0; c < 3; ++c) {
+        float out = (1.0f - hi) * v0[c];
+        out += (hi - mid) * v1[c];
+        out += (mid - lo) * v2[c];
+        out += lo * v3[c];
+        rgb[c] = out;
+    }
+}
+
+#if defined(CURVE_KERNEL_AVX512)
+template <typename T>
+inline LaneVecF normalizeLanes(LaneVec value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm512_castsi512_ps(value);
+    } else {
+        constexpr float scale = sizeof(T) == 1 ? 1.0f / 255.0f : 1.0f / 65535.0f;
+        return _mm512_mul_ps(_mm512_cvtepi32_ps(value), _mm512_set1_ps(scale));
+    }
+}
+
+template <typename T>
+inline LaneVec quantizeLanes(LaneVecF value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm512_castps_si512(value);
+    } else {
+        constexpr float max_value = sizeof(T) == 1 ? 255.0f : 65535.0f;
+        value = _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()), _mm512_set1_ps(1.0f));
+        return _mm512_cvttps_epi32(mulAdd(value, max_value, 0.5f));
+    }
+}
+
+inline void lut3dCell(const Lut3DTable& lut, LaneVecF* rgb) {
+    const int32_t stride[3] = {3, 3 * lut.size, 3 * lut.size * lut.size};
+    const __m512 last_node = _mm512_set1_ps(static_cast<float>(lut.size - 1));
+    __m512 frac[3];
+    __m512i base = _mm512_setzero_si512();
+    for (int32_t c = 0; c < 3; ++c) {
+        __m512 pos = _mm512_fmadd_ps(rgb[c], _mm512_set1_ps(lut.scale[c]),
+                                     _mm512_set1_ps(lut.offset[c]));
+        pos = _mm512_min_ps(_mm512_max_ps(pos, _mm512_setzero_ps()), last_node);
+        __m512i index = _mm512_min_epi32(_mm512_cvttps_epi32(pos), _mm512_set1_epi32(lut.size - 2));
+        frac[c] = _mm512_sub_ps(pos, _mm512_cvtepi32_ps(index));
+        base = _mm512_add_epi32(base, _mm512_mullo_epi32(index, _mm512_set1_epi32(stride[c])));
+    }
+
+    // Same axis choice as lut3dPixel
+    __mmask16 first_r = _mm512_cmp_ps_mask(frac[0], frac[1], _CMP_GE_OQ) &
+                        _mm512_cmp_ps_mask(frac[0], frac[2], _CMP_GE_OQ);
+    __mmask16 first_g = static_cast<__mmask16>(~first_r) &
+                        _mm512_cmp_ps_mask(frac[1], frac[2], _CMP_GE_OQ);
+    __mmask16 last_b = _mm512_cmp_ps_mask(frac[2], frac[0], _CMP_LE_OQ) &
+                       _mm512_cmp_ps_mask(frac[2], frac[1], _CMP_LE_OQ);
+    __mmask16 last_g = static_cast<__mmask16>(~last_b) &
+                       _mm512_cmp_ps_mask(frac[1], frac[0], _CMP_LE_OQ);
+    __m512i first = _mm512_mask_blend_epi32(first_r, _mm512_set1_epi32(stride[2]),
+                                            _mm512_set1_epi32(stride[0]));
+    first = _mm512_mask_blend_epi32(first_g, first, _mm512_set1_epi32(stride[1]));
+    __m512i last = _mm512_mask_blend_epi32(last_b, _mm512_set1_epi32(stride[0]),
+                                           _mm512_set1_epi32(stride[2]));
+    last = _mm512_mask_blend_epi32(last_g, last, _mm512_set1_epi32(stride[1]));
+
+    __m512 hi = _mm512_max_ps(frac[0], _mm512_max_ps(frac[1], frac[2]));
+    __m512 lo = _mm512_min_ps(frac[0], _mm512_min_ps(frac[1], frac[2]));
+    __m512 mid = _mm512_max_ps(_mm512_min_ps(frac[0], frac[1]),
+                               _mm512_min_ps(_mm512_max_ps(frac[0], frac[1]), frac[2]));
+
+    __m512i far = _mm512_add_epi32(base, _mm512_set1_epi32(stride[0] + stride[1] + stride[2]));
+    __m512i v1 = _mm512_add_epi32(base, first);
+    __m512i v2 = _mm512_sub_epi32(far, last);
+    __m512 w0 = _mm512_sub_ps(_mm512_set1_ps(1.0f), hi);
+    __m512 w1 = _mm512_sub_ps(hi, mid);
+    __m512 w2 = _mm512_sub_ps(mid, lo);
+    for (int32_t c = 0; c < 3; ++c) {
+        const float* table = lut.data + c;
+        __m512 out = _mm512_mul_ps(w0, _mm512_i32gather_ps(base, table, 4));
+        out = _mm512_fmadd_ps(w1, _mm512_i32gather_ps(v1, table, 4), out);
+        out = _mm512_fmadd_ps(w2, _mm512_i32gather_ps(v2, table, 4), out);
+        rgb[c] = _mm512_fmadd_ps(lo, _mm512_i32gather_ps(far, table, 4), out);
+    }
+}
+#elif defined(CURVE_KERNEL_AVX2)
+template <typename T>
+inline LaneVecF normalizeLanes(LaneVec value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm256_castsi256_ps(value);
+    } else {
+        constexpr float scale = sizeof(T) == 1 ? 1.0f / 255.0f : 1.0f / 65535.0f;
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(value), _mm256_set1_ps(scale));
+    }
+}
+
+template <typename T>
+inline LaneVec quantizeLanes(LaneVecF value) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        return _mm256_castps_si256(value);
+    } else {
+        constexpr float max_value = sizeof(T) == 1 ? 255.0f : 65535.0f;
+        value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        return _mm256_cvttps_epi32(mulAdd(value, max_value, 0.5f));
+    }
+}
+
+inline __m256i selectLanes(__m256 mask, __m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_castps_si256(mask));
+}
+
+inline void lut3dCell(const Lut3DTable& lut, LaneVecF* rgb) {
+    const int32_t stride[3] = {3, 3 * lut.size, 3 * lut.size * lut.size};
+    const __m256 last_node = _mm256_set1_ps(static_cast<float>(lut.size - 1));
+    __m256 frac[3];
+    __m256i base = _mm256_setzero_si256();
+    for (int32_t c = 0; c < 3; ++c) {
+        __m256 pos = _mm256_fmadd_ps(rgb[c], _mm256_set1_ps(lut.scale[c]),
+                                     _mm256_set1_ps(lut.offset[c]));
+        pos = _mm256_min_ps(_mm256_max_ps(pos, _mm256_setzero_ps()), last_node);
+        __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(pos), _mm256_set1_epi32(lut.size - 2));
+        frac[c] = _mm256_sub_ps(pos, _mm256_cvtepi32_ps(index));
+        base = _mm256_add_epi32(base, _mm256_mullo_epi32(index, _mm256_set1_epi32(stride[c])));
+    }
+
+    // Same axis choice as lut3dPixel
+    __m256 first_r = _mm256_and_ps(_mm256_cmp_ps(frac[0], frac[1], _CMP_GE_OQ),
+                                   _mm256_cmp_ps(frac[0], frac[2], _CMP_GE_OQ));
+    __m256 first_g = _mm256_andnot_ps(first_r, _mm256_cmp_ps(frac[1], frac[2], _CMP_GE_OQ));
+    __m256 last_b = _mm256_and_ps(_mm256_cmp_ps(frac[2], frac[0], _CMP_LE_OQ),
+                                  _mm256_cmp_ps(frac[2], frac[1], _CMP_LE_OQ));
+    __m256 last_g = _mm256_andnot_ps(last_b, _mm256_cmp_ps(frac[1], frac[0], _CMP_LE_OQ));
+    __m256i first = selectLanes(first_r, _mm256_set1_epi32(stride[2]), _mm256_set1_epi32(stride[0]));
+    first = selectLanes(first_g, first, _mm256_set1_epi32(stride[1]));
+    __m256i last = selectLanes(last_b, _mm256_set1_epi32(stride[0]), _mm256_set1_epi32(stride[2]));
+    last = selectLanes(last_g, last, _mm256_set1_epi32(stride[1]));
+
+    __m256 hi = _mm256_max_ps(frac[0], _mm256_max_ps(frac[1], frac[2]));
+    __m256 lo = _mm256_min_ps(frac[0], _mm256_min_ps(frac[1], frac[2]));
+    __m256 mid = _mm256_max_ps(_mm256_min_ps(frac[0], frac[1]),
+                               _mm256_min_ps(_mm256_max_ps(frac[0], frac[1]), frac[2]));
+
+    __m256i far = _mm256_add_epi32(base, _mm256_set1_epi32(stride[0] + stride[1] + stride[2]));
+    __m256i v1 = _mm256_add_epi32(base, first);
+    __m256i v2 = _mm256_sub_epi32(far, last);
+    __m256 w0 = _mm256_sub_ps(_mm256_set1_ps(1.0f), hi);
+    __m256 w1 = _mm256_sub_ps(hi, mid);
+    __m256 w2 = _mm256_sub_ps(mid, lo);
+    for (int32_t c = 0; c < 3; ++c) {
+        const float* table = lut.data + c;
+        __m256 out = _mm256_mul_ps(w0, _mm256_i32gather_ps(table, base, 4));
+        out = _mm256_fmadd_ps(w1, _mm256_i32gather_ps(table, v1, 4), out);
+        out = _mm256_fmadd_ps(w2, _mm256_i32gather_ps(table, v2, 4), out);
+        rgb[c] = _mm256_fmadd_ps(lo, _mm256_i32gather_ps(table, far, 4), out);
+    }
+}
+#endif
+
+template <typename T, bool Swapped>
+struct Lut3DOp {
+    const Lut3DTable& lut;
+
+    float decode(T value) const {
+        if constexpr (sizeof(T) == sizeof(float)) {
+            return value;
+        } else if constexpr (sizeof(T) == 1) {
+            return value * (1.0f / 255.0f);
+        } else {
+            return (Swapped ? swapBytes(value) : value) * (1.0f / 65535.0f);
+        }
+    }
+
+    T encode(float value) const {
+        if constexpr (sizeof(T) == sizeof(float)) {
+            return value;
+        } else {
+            constexpr float max_value = sizeof(T) == 1 ? 255.0f : 65535.0f;
+            float clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+            T code = static_cast<T>(clamped * max_value + 0.5f);
+            if constexpr (Swapped) {
+                return swapBytes(code);
+            } else {
+                return code;
+            }
+        }
+    }
+
+    void pixel(float rgb[3]) const { lut3dPixel(lut, rgb); }
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    LaneVecF decodeLanes(LaneVec value) const { return normalizeLanes<T>(value); }
+    LaneVec encodeLanes(LaneVecF value) const { return quantizeLanes<T>(value); }
+
+    template <int32_t Blocks>
+    void lanes(LaneVecF* rgb) const {
+        for (int32_t k = 0; k < Blocks; ++k) {
+            lut3dCell(lut, rgb + k * 3);
+        }
+    }
+    #endif
+};
+
+template <int32_t Channels>
+void applyLut3D8(const KernelImage& image, const Lut3DTable& lut) {
+    applyRGBOp<uint8_t, Channels, false>(image, Lut3DOp<uint8_t, false>{lut});
+}
+
+template <int32_t Channels, bool Swapped>
+void applyLut3D16(const KernelImage& image, const Lut3DTable& lut) {
+    applyRGBOp<uint16_t, Channels, Swapped>(image, Lut3DOp<uint16_t, Swapped>{lut});
+}
+
+template <int32_t Channels>
+void applyLut3DFloat(const KernelImage& image, const Lut3DTable& lut) {
+    applyRGBOp<float, Channels, false>(image, Lut3DOp<float, false>{lut});
+}
+
+// =============================================================================
+// Image analysis
+// =============================================================================
+
+template <typename T>
+constexpr float kFullScale = sizeof(T) == 1 ? 255.0f : (sizeof(T) == 2 ? 65535.0f : 1.0f);
+
+// Float luma is summed in double, where the products are exact, so the
+// result (and its bin) does not depend on whether the compiler fuses them
+constexpr double kLumaWeights[3] = {LUMA_WEIGHT_R, LUMA_WEIGHT_G, LUMA_WEIGHT_B};
+
+inline int32_t analysisBin(double luma) {
+    // NaN fails the comparison and lands in bin 0 with the negatives
+    double scaled = luma * ANALYSIS_BINS > 0.0 ? luma * ANALYSIS_BINS : 0.0;
+    return scaled < ANALYSIS_BINS - 1 ? static_cast<int32_t>(scaled) : ANALYSIS_BINS - 1;
+}
+
+/**
+ * Normalized luma of one pixel and its histogram bin
+ * r, g and b are native-order samples; Gray passes the one channel.
+ */
+template <typename T, bool Gray>
+inline double analysisLuma(T r, T g, T b, int32_t& bin) {
+    if constexpr (sizeof(T) == sizeof(float)) {
+        double luma = Gray ? r : kLumaWeights[0] * r + kLumaWeights[1] * g + kLumaWeights[2] * b;
+        bin = analysisBin(luma);
+        return luma;
+    } else if constexpr (sizeof(T) == 1) {
+        int32_t luma = Gray ? r : (LUMA8_WEIGHTS[0] * r + LUMA8_WEIGHTS[1] * g +
+                                   LUMA8_WEIGHTS[2] * b + 128) >> 8;
+        bin = luma;
+        return luma * (1.0 / 255.0);
+    } else {
+        uint32_t luma = Gray ? r : (LUMA16_WEIGHTS[0] * uint32_t(r) + LUMA16_WEIGHTS[1] * uint32_t(g) +
+                                    LUMA16_WEIGHTS[2] * uint32_t(b) + 32768u) >> 16;
+        bin = static_cast<int32_t>(luma >> 8);
+        return luma * (1.0 / 65535.0);
+    }
+}
+
+/**
+ * Scalar analysis of pixels [first, end) of a row; Channels 0 reads
+ * image.channels at run time and counts channel 0 as gray when there
+ * are fewer than 3
+ */
+template <typename T, int32_t Channels, bool Swapped>
+inline void analyzePixels(const KernelImage& image, const T* row, int32_t first, int32_t end,
+                          AnalysisSums& sums) {
+    const int32_t channels = Channels ? Channels : image.channels;
+    const bool gray = channels < 3;
+    constexpr double scale = 1.0 / kFullScale<T>;
+
+    for (int32_t x = first; x < end; ++x) {
+        const T* s = row + x * channels;
+        T rgb[3];
+        for (int32_t c = 0; c < 3; ++c) {
+            rgb[c] = s[gray ? 0 : c];
+            if constexpr (Swapped) {
+                rgb[c] = swapBytes(rgb[c]);
+            }
+        }
+
+        int32_t bin;
+        double luma = gray ? analysisLuma<T, true>(rgb[0], rgb[0], rgb[0], bin)
+                           : analysisLuma<T, false>(rgb[0], rgb[1], rgb[2], bin);
+        ++sums.histogram[bin];
+        double offset = luma - sums.pivot;
+        sums.luma += offset;
+        sums.luma_squares += offset * offset;
+
+        for (int32_t c = 0; c < 3; ++c) {
+            sums.channel[c] += rgb[c] * scale;
+        }
+        T darkest = minOf(rgb[0], minOf(rgb[1], rgb[2]));
+        T brightest = maxOf(rgb[0], maxOf(rgb[1], rgb[2]));
+        sums.shadows += darkest <= T(0);
+        sums.highlights += brightest >= static_cast<T>(kFullScale<T>);
+    }
+}
+
+// The vector path widens each block to two halves of double lanes for
+// the luma and channel sums; bins and clipping stay in 32-bit lanes
+#if defined(CURVE_KERNEL_AVX512)
+using LaneVecD = __m512d;
+
+inline void widenLanes(LaneVecF value, LaneVecD* halves) {
+    halves[0] = _mm512_cvtps_pd(_mm512_castps512_ps256(value));
+    halves[1] = _mm512_cvtps_pd(_mm512_extractf32x8_ps(value, 1));
+}
+
+inline void widenLanes(LaneVec value, LaneVecD* halves) {
+    halves[0] = _mm512_cvtepi32_pd(_mm512_castsi512_si256(value));
+    halves[1] = _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(value, 1));
+}
+
+// Bins of two halves of luma, clamped like analysisBin
+inline LaneVec binLanes(const LaneVecD* luma) {
+    __m256i halves[2];
+    for (int32_t h = 0; h < 2; ++h) {
+        __m512d scaled = _mm512_max_pd(_mm512_mul_pd(luma[h], _mm512_set1_pd(ANALYSIS_BINS)),
+                                       _mm512_setzero_pd());
+        scaled = _mm512_min_pd(scaled, _mm512_set1_pd(ANALYSIS_BINS - 1));
+        halves[h] = _mm512_cvttpd_epi32(scaled);
+    }
+    return _mm512_inserti64x4(_mm512_castsi256_si512(halves[0]), halves[1], 1);
+}
+
+inline LaneVecD splatD(double value) { return _mm512_set1_pd(value); }
+inline LaneVecD addD(LaneVecD a, LaneVecD b) { return _mm512_add_pd(a, b); }
+inline LaneVecD subD(LaneVecD a, LaneVecD b) { return _mm512_sub_pd(a, b); }
+inline LaneVecD mulD(LaneVecD a, LaneVecD b) { return _mm512_mul_pd(a, b); }
+inline LaneVecD mulAddD(LaneVecD a, LaneVecD b, LaneVecD c) { return _mm512_fmadd_pd(a, b, c); }
+inline double sumLanes(LaneVecD value) { return _mm512_reduce_add_pd(value); }
+#elif defined(CURVE_KERNEL_AVX2)
+using LaneVecD = __m256d;
+
+inline void widenLanes(LaneVecF value, LaneVecD* halves) {
+    halves[0] = _mm256_cvtps_pd(_mm256_castps256_ps128(value));
+    halves[1] = _mm256_cvtps_pd(_mm256_extractf128_ps(value, 1));
+}
+
+inline void widenLanes(LaneVec value, LaneVecD* halves) {
+    halves[0] = _mm256_cvtepi32_pd(_mm256_castsi256_si128(value));
+    halves[1] = _mm256_cvtepi32_pd(_mm256_extracti128_si256(value, 1));
+}
+
+inline LaneVec binLanes(const LaneVecD* luma) {
+    __m128i halves[2];
+    for (int32_t h = 0; h < 2; ++h) {
+        // max_pd returns its second operand for NaN, so NaN goes to bin 0
+        __m256d scaled = _mm256_max_pd(_mm256_mul_pd(luma[h], _mm256_set1_pd(ANALYSIS_BINS)),
+                                       _mm256_setzero_pd());
+        scaled = _mm256_min_pd(scaled, _mm256_set1_pd(ANALYSIS_BINS - 1));
+        halves[h] = _mm256_cvttpd_epi32(scaled);
+    }
+    return _mm256_set_m128i(halves[1], halves[0]);
+}
+
+inline LaneVecD splatD(double value) { return _mm256_set1_pd(value); }
+inline LaneVecD addD(LaneVecD a, LaneVecD b) { return _mm256_add_pd(a, b); }
+inline LaneVecD subD(LaneVecD a, LaneVecD b) { return _mm256_sub_pd(a, b); }
+inline LaneVecD mulD(LaneVecD a, LaneVecD b) { return _mm256_mul_pd(a, b); }
+inline LaneVecD mulAddD(LaneVecD a, LaneVecD b, LaneVecD c) { return _mm256_fmadd_pd(a, b, c); }
+
+inline double sumLanes(LaneVecD value) {
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+#endif
+
+#if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+/**
+ * Per-lane partial sums of the vector path
+ * Clip counts are per-lane int32 and are flushed every row.
+ */
+struct AnalysisLanes {
+    LaneVecD luma = splatD(0.0);
+    LaneVecD luma_squares = splatD(0.0);
+    LaneVecD channel[3] = {splatD(0.0), splatD(0.0), splatD(0.0)};
+    LaneVec shadows;
+    LaneVec highlights;
+};
+
+/**
+ * Analyze one block of kLanes pixels starting at s
+ */
+template <typename T, int32_t Channels, bool Swapped>
+inline void analyzeBlock(const T* s, LaneVecD pivot, AnalysisLanes& lanes, uint64_t* histogram) {
+    constexpr bool is_float = sizeof(T) == sizeof(float);
+    LaneVec samples[Channels];
+    LaneVec rgb[3];
+    for (int32_t m = 0; m < Channels; ++m) {
+        samples[m] = loadLanes<T, Swapped>(s + m * kLanes);
+    }
+    splitRGB<Channels>(samples, rgb);
+
+    // Channels in double, normalized
+    LaneVecD channel[3][2];
+    for (int32_t c = 0; c < 3; ++c) {
+        if constexpr (is_float) {
+            #if defined(CURVE_KERNEL_AVX512)
+            widenLanes(_mm512_castsi512_ps(rgb[c]), channel[c]);
+            #else
+            widenLanes(_mm256_castsi256_ps(rgb[c]), channel[c]);
+            #endif
+        } else {
+            widenLanes(rgb[c], channel[c]);
+            for (int32_t h = 0; h < 2; ++h) {
+                channel[c][h] = mulD(channel[c][h], splatD(1.0 / kFullScale<T>));
+            }
+        }
+    }
+
+    // Luma in double and its bins
+    LaneVecD luma[2];
+    LaneVec bins;
+    if constexpr (is_float) {
+        for (int32_t h = 0; h < 2; ++h) {
+            luma[h] = addD(addD(mulD(channel[0][h], splatD(kLumaWeights[0])),
+                                mulD(channel[1][h], splatD(kLumaWeights[1]))),
+                           mulD(channel[2][h], splatD(kLumaWeights[2])));
+        }
+        bins = binLanes(luma);
+    } else {
+        constexpr bool wide = sizeof(T) == 2;
+        const int32_t* weights = wide ? LUMA16_WEIGHTS : LUMA8_WEIGHTS;
+        #if defined(CURVE_KERNEL_AVX512)
+        __m512i fixed = _mm512_add_epi32(
+            _mm512_add_epi32(_mm512_mullo_epi32(rgb[0], _mm512_set1_epi32(weights[0])),
+                             _mm512_mullo_epi32(rgb[1], _mm512_set1_epi32(weights[1]))),
+            _mm512_add_epi32(_mm512_mullo_epi32(rgb[2], _mm512_set1_epi32(weights[2])),
+                             _mm512_set1_epi32(wide ? 32768 : 128)));
+        fixed = _mm512_srli_epi32(fixed, wide ? 16 : 8);
+        bins = wide ? _mm512_srli_epi32(fixed, 8) : fixed;
+        #else
+        __m256i fixed = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(rgb[0], _mm256_set1_epi32(weights[0])),
+                             _mm256_mullo_epi32(rgb[1], _mm256_set1_epi32(weights[1]))),
+            _mm256_add_epi32(_mm256_mullo_epi32(rgb[2], _mm256_set1_epi32(weights[2])),
+                             _mm256_set1_epi32(wide ? 32768 : 128)));
+        fixed = _mm256_srli_epi32(fixed, wide ? 16 : 8);
+        bins = wide ? _mm256_srli_epi32(fixed, 8) : fixed;
+        #endif
+        widenLanes(fixed, luma);
+        for (int32_t h = 0; h < 2; ++h) {
+            luma[h] = mulD(luma[h], splatD(1.0 / kFullScale<T>));
+        }
+    }
+
+    for (int32_t h = 0; h < 2; ++h) {
+        LaneVecD offset = subD(luma[h], pivot);
+        lanes.luma = addD(lanes.luma, offset);
+        lanes.luma_squares = mulAddD(offset, offset, lanes.luma_squares);
+        for (int32_t c = 0; c < 3; ++c) {
+            lanes.channel[c] = addD(lanes.channel[c], channel[c][h]);
+        }
+    }
+
+    // Clipping: integer samples at 0 or full scale, float at <= 0 or >= 1
+    #if defined(CURVE_KERNEL_AVX512)
+    __mmask16 shadow;
+    __mmask16 highlight;
+    if constexpr (is_float) {
+        __m512 r = _mm512_castsi512_ps(rgb[0]);
+        __m512 g = _mm512_castsi512_ps(rgb[1]);
+        __m512 b = _mm512_castsi512_ps(rgb[2]);
+        shadow = _mm512_cmp_ps_mask(_mm512_min_ps(r, _mm512_min_ps(g, b)),
+                                    _mm512_setzero_ps(), _CMP_LE_OQ);
+        highlight = _mm512_cmp_ps_mask(_mm512_max_ps(r, _mm512_max_ps(g, b)),
+                                       _mm512_set1_ps(1.0f), _CMP_GE_OQ);
+    } else {
+        __m512i darkest = _mm512_min_epi32(rgb[0], _mm512_min_epi32(rgb[1], rgb[2]));
+        __m512i brightest = _mm512_max_epi32(rgb[0], _mm512_max_epi32(rgb[1], rgb[2]));
+        shadow = _mm512_cmpeq_epi32_mask(darkest, _mm512_setzero_si512());
+        highlight = _mm512_cmpeq_epi32_mask(
+            brightest, _mm512_set1_epi32(static_cast<int32_t>(kFullScale<T>)));
+    }
+    lanes.shadows = _mm512_mask_sub_epi32(lanes.shadows, shadow, lanes.shadows,
+                                          _mm512_set1_epi32(-1));
+    lanes.highlights = _mm512_mask_sub_epi32(lanes.highlights, highlight, lanes.highlights,
+                                             _mm512_set1_epi32(-1));
+    #else
+    __m256i shadow;
+    __m256i highlight;
+    if constexpr (is_float) {
+        __m256 r = _mm256_castsi256_ps(rgb[0]);
+        __m256 g = _mm256_castsi256_ps(rgb[1]);
+        __m256 b = _mm256_castsi256_ps(rgb[2]);
+        shadow = _mm256_castps_si256(_mm256_cmp_ps(_mm256_min_ps(r, _mm256_min_ps(g, b)),
+                                                   _mm256_setzero_ps(), _CMP_LE_OQ));
+        highlight = _mm256_castps_si256(_mm256_cmp_ps(_mm256_max_ps(r, _mm256_max_ps(g, b)),
+                                                      _mm256_set1_ps(1.0f), _CMP_GE_OQ));
+    } else {
+        __m256i darkest = _mm256_min_epi32(rgb[0], _mm256_min_epi32(rgb[1], rgb[2]));
+        __m256i brightest = _mm256_max_epi32(rgb[0], _mm256_max_epi32(rgb[1], rgb[2]));
+        shadow = _mm256_cmpeq_epi32(darkest, _mm256_setzero_si256());
+        highlight = _mm256_cmpeq_epi32(
+            brightest, _mm256_set1_epi32(static_cast<int32_t>(kFullScale<T>)));
+    }
+    // Compare masks are -1 per set lane
+    lanes.shadows = _mm256_sub_epi32(lanes.shadows, shadow);
+    lanes.highlights = _mm256_sub_epi32(lanes.highlights, highlight);
+    #endif
+
+    alignas(64) int32_t lane_bins[kLanes];
+    std::memcpy(lane_bins, &bins, sizeof(lane_bins));
+    for (int32_t lane = 0; lane < kLanes; ++lane) {
+        ++histogram[lane_bins[lane]];
+    }
+}
+
+// Horizontal sum of per-lane int32 counts
+inline uint64_t countLanes(LaneVec counts) {
+    alignas(64) int32_t values[kLanes];
+    std::memcpy(values, &counts, sizeof(values));
+    uint64_t total = 0;
+    for (int32_t lane = 0; lane < kLanes; ++lane) {
+        total += static_cast<uint32_t>(values[lane]);
+    }
+    return total;
+}
+#endif
+
+template <typename T, int32_t Channels, bool Swapped>
+void analyze(const KernelImage& image, AnalysisSums& sums) {
+    std::memset(&sums, 0, sizeof(sums));
+    if (image.width <= 0 || image.height <= 0) {
+        return;
+    }
+
+    // Pivot on the first pixel: its luma is close enough to the mean of a
+    // band that the squared offsets keep their precision
+    {
+        AnalysisSums first = {};
+        analyzePixels<T, Channels, Swapped>(image, reinterpret_cast<const T*>(srcRow(image, 0)),
+                                            0, 1, first);
+        sums.pivot = first.luma;
+    }
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    AnalysisLanes lanes;
+    const LaneVecD pivot = splatD(sums.pivot);
+    #endif
+
+    for (int32_t y = 0; y < image.height; ++y) {
+        const T* row = reinterpret_cast<const T*>(srcRow(image, y));
+        int32_t x = 0;
+
+        #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+        if constexpr (Channels != 0) {
+            std::memset(&lanes.shadows, 0, sizeof(lanes.shadows));
+            std::memset(&lanes.highlights, 0, sizeof(lanes.highlights));
+            for (; x + kLanes <= image.width; x += kLanes) {
+                analyzeBlock<T, Channels, Swapped>(row + x * Channels, pivot, lanes,
+                                                   sums.histogram);
+            }
+            sums.shadows += countLanes(lanes.shadows);
+            sums.highlights += countLanes(lanes.highlights);
+        }
+        #endif
+
+        analyzePixels<T, Channels, Swapped>(image, row, x, image.width, sums);
+    }
+
+    #if defined(CURVE_KERNEL_AVX2) || defined(CURVE_KERNEL_AVX512)
+    sums.luma += sumLanes(lanes.luma);
+    sums.luma_squares += sumLanes(lanes.luma_squares);
+    for (int32_t c = 0; c < 3; ++c) {
+        sums.channel[c] += sumLanes(lanes.channel[c]);
+    }
+    #endif
+}
+
+} // namespace
+
+// One row per layout (any, RGB, RGBA), one entry per curved channel mask
+#define CURVE_KERNEL_MASKS(kernel, channels) {                       \
+    &kernel<channels, 0>, &kernel<channels, 1>, &kernel<channels, 2>, \
+    &kernel<channels, 3>, &kernel<channels, 4>, &kernel<channels, 5>, \
+    &kernel<channels, 6>, &kernel<channels, 7> }
+
+#define CURVE_KERNEL_LAYOUTS(kernel) {                                \
+    CURVE_KERNEL_MASKS(kernel, 0),                                     \
+    CURVE_KERNEL_MASKS(kernel, 3),                                     \
+    CURVE_KERNEL_MASKS(kernel, 4) }
+
+const KernelTable& kernelTable() {
+    static const KernelTable table = {
+        CURVE_KERNEL_LEVEL,
+        CURVE_KERNEL_NAME,
+        CURVE_KERNEL_LAYOUTS(applyLUT8),
+        CURVE_KERNEL_LAYOUTS(applyLUT16),
+        CURVE_KERNEL_LAYOUTS(applyLUTFloat),
+        {&applyLuma8<3>, &applyLuma8<4>},
+        {{&applyLuma16<3, false>, &applyLuma16<3, true>},
+         {&applyLuma16<4, false>, &applyLuma16<4, true>}},
+        {&applyLumaFloat<3>, &applyLumaFloat<4>},
+        {&applyLab8<3>, &applyLab8<4>},
+        {{&applyLab16<3, false>, &applyLab16<3, true>},
+         {&applyLab16<4, false>, &applyLab16<4, true>}},
+        {&applyLabFloat<3>, &applyLabFloat<4>},
+        {&applyLut3D8<3>, &applyLut3D8<4>},
+        {{&applyLut3D16<3, false>, &applyLut3D16<3, true>},
+         {&applyLut3D16<4, false>, &applyLut3D16<4, true>}},
+        {&applyLut3DFloat<3>, &applyLut3DFloat<4>},
+        {&analyze<uint8_t, 0, false>, &analyze<uint8_t, 3, false>, &analyze<uint8_t, 4, false>},
+        {{&analyze<uint16_t, 0, false>, &analyze<uint16_t, 0, true>},
+         {&analyze<uint16_t, 3, false>, &analyze<uint16_t, 3, true>},
+         {&analyze<uint16_t, 4, false>, &analyze<uint16_t, 4, true>}},
+        {&analyze<float, 0, false>, &analyze<float, 3, false>, &analyze<float, 4, false>}
+    };
+    return table;
+}
+
+#undef CURVE_KERNEL_LAYOUTS
+#undef CURVE_KERNEL_MASKS
+
+} // namespace CURVE_KERNEL_ISA
+} // namespace Kernels
+} // namespace PhotoStudioPro
+
+#undef CURVE_KERNEL_AVX2
+#undef CURVE_KERNEL_AVX512
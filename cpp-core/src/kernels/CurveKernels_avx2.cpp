@@ -0,0 +1,11 @@
+/*
+ * Curve Kernels - AVX2 build
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#define CURVE_KERNEL_ISA avx2
+#define CURVE_KERNEL_LEVEL IsaLevel::AVX2
+#define CURVE_KERNEL_NAME "avx2"
+
+#include "kernels/CurveKernelsImpl.h"
@@ -0,0 +1,23 @@
+/*
+ * Curve Kernels - AVX512 build
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#define CURVE_KERNEL_ISA avx512
+#define CURVE_KERNEL_LEVEL IsaLevel::AVX512
+#define CURVE_KERNEL_NAME "avx512"
+
+// GCC before 13 reports its own AVX-512 intrinsics as reading an
+// uninitialized __Y (GCC bug 105593). Include them first with those
+// warnings off; the include guard keeps CurveKernelsImpl.h from pulling
+// them in again, so the kernels themselves are still checked.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+#include "kernels/CurveKernelsImpl.h"
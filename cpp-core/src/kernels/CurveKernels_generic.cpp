@@ -0,0 +1,11 @@
+/*
+ * Curve Kernels - GENERIC build
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#define CURVE_KERNEL_ISA generic
+#define CURVE_KERNEL_LEVEL IsaLevel::GENERIC
+#define CURVE_KERNEL_NAME "generic"
+
+#include "kernels/CurveKernelsImpl.h"
@@ -0,0 +1,11 @@
+/*
+ * Curve Kernels - SSE42 build
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#define CURVE_KERNEL_ISA sse42
+#define CURVE_KERNEL_LEVEL IsaLevel::SSE42
+#define CURVE_KERNEL_NAME "sse4.2"
+
+#include "kernels/CurveKernelsImpl.h"
@@ -0,0 +1,94 @@
+/*
+ * Lab Tables - Curve-Independent Colour Conversion Tables
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "kernels/LabTables.h"
+
+#include <cmath>
+#include <vector>
+
+namespace PhotoStudioPro {
+namespace Kernels {
+
+namespace {
+
+constexpr double LAB_DELTA = 6.0 / 29.0;
+
+template <typename Fn>
+std::vector<float> sampleTable(int32_t size, Fn fn) {
+    std::vector<float> table(size);
+    for (int32_t i = 0; i < size; ++i) {
+        table[i] = static_cast<float>(fn(static_cast<double>(i) / (size - 1)));
+    }
+    return table;
+}
+
+/**
+ * Least-squares line per float-bits bucket through 65536 * (code + 0.5),
+ * so the kernels' (bias * 512 + scale * t) >> 16 rounds to the nearest code
+ */
+std::vector<uint32_t> buildEncodeTable8() {
+    std::vector<uint32_t> table(SRGB_ENCODE8_SIZE);
+    for (int32_t bucket = 0; bucket < SRGB_ENCODE8_SIZE; ++bucket) {
+        int32_t exponent = -13 + bucket / 8;
+        double sum_t = 0.0, sum_y = 0.0, sum_tt = 0.0, sum_ty = 0.0;
+        for (int32_t t = 0; t < 256; ++t) {
+            double mantissa = (bucket % 8) / 8.0 + (t + 0.5) / 2048.0;
+            double y = 65536.0 * (255.0 * linearToSrgb(std::ldexp(1.0 + mantissa, exponent)) + 0.5);
+            sum_t += t;
+            sum_y += y;
+            sum_tt += static_cast<double>(t) * t;
+            sum_ty += t * y;
+        }
+        double scale = (256.0 * sum_ty - sum_t * sum_y) / (256.0 * sum_tt - sum_t * sum_t);
+        double bias = (sum_y - scale * sum_t) / 256.0;
+        table[bucket] = static_cast<uint32_t>(std::lround(bias / 512.0)) << 16 |
+                        static_cast<uint32_t>(std::lround(scale));
+    }
+    return table;
+}
+
+} // namespace
+
+double srgbToLinear(double value) {
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+double linearToSrgb(double value) {
+    return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+}
+
+double labF(double t) {
+    return t > LAB_DELTA * LAB_DELTA * LAB_DELTA
+        ? std::cbrt(t)
+        : t / (3.0 * LAB_DELTA * LAB_DELTA) + 4.0 / 29.0;
+}
+
+double labFInverse(double f) {
+    return f > LAB_DELTA ? f * f * f : 3.0 * LAB_DELTA * LAB_DELTA * (f - 4.0 / 29.0);
+}
+
+const float* srgbDecodeTable8() {
+    static const std::vector<float> table = sampleTable(256, srgbToLinear);
+    return table.data();
+}
+
+const float* srgbDecodeTable16() {
+    static const std::vector<float> table = sampleTable(65536, srgbToLinear);
+    return table.data();
+}
+
+const float* srgbEncodeTable() {
+    static const std::vector<float> table = sampleTable(SRGB_ENCODE_SIZE, linearToSrgb);
+    return table.data();
+}
+
+const uint32_t* srgbEncodeTable8() {
+    static const std::vector<uint32_t> table = buildEncodeTable8();
+    return table.data();
+}
+
+} // namespace Kernels
+} // namespace PhotoStudioPro
@@ -0,0 +1,43 @@
+/*
+ * Lab Tables - Curve-Independent Colour Conversion Tables
+ * sRGB transfer and CIE Lab companding, sampled once for the Lab kernels
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include "kernels/CurveKernels.h"
+
+namespace PhotoStudioPro {
+namespace Kernels {
+
+/**
+ * sRGB-encoded sample value to linear light, indexed by 8-bit code
+ */
+const float* srgbDecodeTable8();
+
+/**
+ * As srgbDecodeTable8, indexed by 16-bit code
+ */
+const float* srgbDecodeTable16();
+
+/**
+ * Linear light to sRGB encoding over [0, 1], SRGB_ENCODE_SIZE samples
+ */
+const float* srgbEncodeTable();
+
+/**
+ * Linear light to 8-bit sRGB code, bucketed by float bits (see
+ * SRGB_ENCODE8_SIZE); within 0.55 LSB of the exact encoding
+ */
+const uint32_t* srgbEncodeTable8();
+
+// Exact forms the tables are sampled from
+double srgbToLinear(double value);
+double linearToSrgb(double value);
+double labF(double t);
+double labFInverse(double f);
+
+} // namespace Kernels
+} // namespace PhotoStudioPro
@@ -0,0 +1,193 @@
+/*
+ * Test Support - Checks and Fixtures Shared by the Kernel Tests
+ * Each test is a plain executable run by CTest: failed checks are printed
+ * and counted, and main returns the count.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#pragma once
+
+#include "AdvancedCurveProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace CurveTests {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+#define CURVE_CHECK(condition, ...)                                         \
+    do {                                                                    \
+        if (!(condition)) {                                                 \
+            std::fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);            \
+            std::fprintf(stderr, __VA_ARGS__);                              \
+            std::fputc('\n', stderr);                                       \
+            ++CurveTests::failureCount();                                   \
+        }                                                                   \
+    } while (0)
+
+/**
+ * Kernel level under test, with a name for failure messages
+ */
+struct IsaCase {
+    CurveIsaLevel level;
+    const char* name;
+};
+
+/**
+ * Every level this CPU and build support, lowest first
+ * Leaves the last supported level selected; callers pick per case.
+ */
+inline std::vector<IsaCase> supportedIsaLevels() {
+    const IsaCase all[] = {
+        {CURVE_ISA_GENERIC, "generic"},
+        {CURVE_ISA_SSE42, "sse42"},
+        {CURVE_ISA_AVX2, "avx2"},
+        {CURVE_ISA_AVX512, "avx512"},
+    };
+    std::vector<IsaCase> levels;
+    for (const IsaCase& isa : all) {
+        if (curve_set_isa_level(isa.level) == CURVE_SUCCESS) {
+            levels.push_back(isa);
+        }
+    }
+    return levels;
+}
+
+/**
+ * Curve's master LUT as generated by the engine
+ */
+class MasterLUT {
+public:
+    explicit MasterLUT(const CurveData& curve) {
+        double* lut = nullptr;
+        int32_t size = 0;
+        if (curve_generate_lut(&curve, &lut, &size) == CURVE_SUCCESS) {
+            values_.assign(lut, lut + size);
+            delete[] lut;
+        }
+    }
+
+    bool valid() const { return values_.size() >= 2; }
+
+    /**
+     * Linear interpolation at x, clamped to [0, 1]
+     */
+    double sample(double x) const {
+        double position = std::clamp(x, 0.0, 1.0) * (values_.size() - 1);
+        size_t index = static_cast<size_t>(position);
+        if (index >= values_.size() - 1) {
+            return values_.back();
+        }
+        double fraction = position - index;
+        return values_[index] + fraction * (values_[index + 1] - values_[index]);
+    }
+
+    /**
+     * Integer sample code through the curve, rounded like the kernels
+     */
+    int32_t sampleCode(int32_t code, int32_t max_code) const {
+        double value = sample(static_cast<double>(code) / max_code) * max_code + 0.5;
+        return static_cast<int32_t>(std::clamp(value, 0.0, static_cast<double>(max_code)));
+    }
+
+private:
+    std::vector<double> values_;
+};
+
+/**
+ * Non-monotonic S-curve used by most cases
+ */
+inline CurveData* createTestCurve(CurveType type = CURVE_TYPE_CUBIC_SPLINE) {
+    const CurvePoint points[] = {
+        {0.0, 0.05}, {0.25, 0.2}, {0.5, 0.55}, {0.75, 0.85}, {1.0, 0.97}
+    };
+    CurveData* curve = nullptr;
+    curve_create(points, 5, type, &curve);
+    return curve;
+}
+
+/**
+ * Deterministic bytes for test images (xorshift32)
+ */
+inline void fillNoise(std::vector<uint8_t>& buffer, uint32_t seed) {
+    uint32_t state = seed ? seed : 1;
+    for (uint8_t& byte : buffer) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+}
+
+/**
+ * Bytes per sample of a format
+ */
+inline size_t sampleBytes(ImageFormat format) {
+    switch (format) {
+        case FORMAT_RGB16:
+        case FORMAT_RGBA16:
+            return 2;
+        case FORMAT_RGB32F:
+        case FORMAT_RGBA32F:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * Noise image of count samples; float samples are spread over [0, 1]
+ */
+inline std::vector<uint8_t> noiseSamples(ImageFormat format, size_t count, uint32_t seed) {
+    std::vector<uint8_t> pixels(count * sampleBytes(format));
+    fillNoise(pixels, seed);
+    if (sampleBytes(format) == 4) {
+        auto* samples = reinterpret_cast<float*>(pixels.data());
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = (pixels[i * 4] | (pixels[i * 4 + 1] << 8)) / 65535.0f;
+        }
+    }
+    return pixels;
+}
+
+/**
+ * Largest sample difference between two images of one format
+ */
+inline double maxDifference(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b,
+                            ImageFormat format) {
+    double largest = 0.0;
+    size_t bytes = sampleBytes(format);
+    for (size_t i = 0; i < a.size(); i += bytes) {
+        double difference;
+        if (bytes == 4) {
+            difference = std::fabs(*reinterpret_cast<const float*>(&a[i]) -
+                                   *reinterpret_cast<const float*>(&b[i]));
+        } else if (bytes == 2) {
+            difference = std::abs(*reinterpret_cast<const uint16_t*>(&a[i]) -
+                                  *reinterpret_cast<const uint16_t*>(&b[i]));
+        } else {
+            difference = std::abs(a[i] - b[i]);
+        }
+        largest = std::max(largest, difference);
+    }
+    return largest;
+}
+
+/**
+ * Pointer to row y of a strided buffer
+ */
+template <typename T>
+T* row(std::vector<uint8_t>& buffer, size_t stride, int32_t y) {
+    return reinterpret_cast<T*>(buffer.data() + stride * y);
+}
+
+} // namespace CurveTests
@@ -0,0 +1,250 @@
+/*
+ * Color mode tests
+ * Luminance-preserving and Lab curves at every supported ISA level:
+ * float luminance output against the documented curve(Y) / Y scaling on
+ * the master LUT, gray ramps against the curve itself, Lab round trips
+ * through identity curves, and every level against the generic kernels.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace CurveTests;
+
+namespace {
+
+constexpr int32_t WIDTH = 97;    // Odd, so vector loops have a tail
+constexpr int32_t HEIGHT = 11;
+
+// Rec.601 weights of luminance mode
+constexpr double LUMA_WEIGHTS[3] = {0.299, 0.587, 0.114};
+
+std::vector<uint8_t> makeImage(ImageFormat format, int32_t channels, uint32_t seed) {
+    return noiseSamples(format, static_cast<size_t>(WIDTH) * HEIGHT * channels, seed);
+}
+
+std::vector<uint8_t> applyCurve(const CurveData& curve, std::vector<uint8_t>& pixels,
+                                ImageFormat format, int32_t channels) {
+    std::vector<uint8_t> result(pixels.size());
+    size_t stride = WIDTH * channels * sampleBytes(format);
+    ImageData in = {pixels.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = result.data();
+    CurveResult status = curve_apply_to_image(&curve, &in, &out, nullptr);
+    CURVE_CHECK(status == CURVE_SUCCESS, "format %d channel %d: apply returned %d",
+                format, curve.channel, status);
+    return result;
+}
+
+// =============================================================================
+// Luminance mode
+// =============================================================================
+
+void testLuminanceFloat(const IsaCase& isa, int32_t channels) {
+    ImageFormat format = channels == 4 ? FORMAT_RGBA32F : FORMAT_RGB32F;
+    std::vector<uint8_t> pixels = makeImage(format, channels, 3);
+    auto* samples = reinterpret_cast<float*>(pixels.data());
+    samples[0] = samples[1] = samples[2] = 0.0f;   // Y == 0 takes the black level
+
+    CurveData* curve = createTestCurve();
+    curve->channel = CHANNEL_LUMINANCE;
+    MasterLUT master(*curve);
+    std::vector<uint8_t> result = applyCurve(*curve, pixels, format, channels);
+    const auto* output = reinterpret_cast<const float*>(result.data());
+
+    double max_error = 0.0;
+    for (int32_t p = 0; p < WIDTH * HEIGHT; ++p) {
+        const float* in = samples + p * channels;
+        const float* out = output + p * channels;
+        double luma = LUMA_WEIGHTS[0] * in[0] + LUMA_WEIGHTS[1] * in[1] +
+                      LUMA_WEIGHTS[2] * in[2];
+        double mapped = master.sample(luma);
+        double brightest = std::max({in[0], in[1], in[2]});
+        double gain = luma > 1e-6 ? mapped / luma : 0.0;
+        double lift = luma > 1e-6 ? 0.0 : mapped;
+        if (brightest * gain > 1.0) {
+            gain = 1.0 / brightest;
+        }
+        for (int32_t c = 0; c < 3; ++c) {
+            max_error = std::max(max_error, std::fabs(in[c] * gain + lift - out[c]));
+        }
+        if (channels == 4) {
+            CURVE_CHECK(out[3] == in[3], "%s: alpha of pixel %d changed", isa.name, p);
+        }
+    }
+    CURVE_CHECK(max_error <= 1e-4, "%s C%d luminance: max error %g",
+                isa.name, channels, max_error);
+    curve_destroy(curve);
+}
+
+/**
+ * Gray pixels have Y equal to their value, so they follow the curve
+ */
+template <typename T>
+void testLuminanceGray(const IsaCase& isa, ImageFormat format) {
+    constexpr int32_t max_code = sizeof(T) == 1 ? 255 : 65535;
+    std::vector<uint8_t> pixels(WIDTH * HEIGHT * 3 * sizeof(T));
+    auto* samples = reinterpret_cast<T*>(pixels.data());
+    for (int32_t p = 0; p < WIDTH * HEIGHT; ++p) {
+        T value = static_cast<T>(static_cast<int64_t>(p) * max_code / (WIDTH * HEIGHT - 1));
+        samples[p * 3] = samples[p * 3 + 1] = samples[p * 3 + 2] = value;
+    }
+
+    CurveData* curve = createTestCurve();
+    curve->channel = CHANNEL_LUMINANCE;
+    MasterLUT master(*curve);
+    std::vector<uint8_t> result = applyCurve(*curve, pixels, format, 3);
+    const auto* output = reinterpret_cast<const T*>(result.data());
+
+    int32_t max_error = 0;
+    for (int32_t p = 0; p < WIDTH * HEIGHT; ++p) {
+        int32_t expected = master.sampleCode(samples[p * 3], max_code);
+        for (int32_t c = 0; c < 3; ++c) {
+            max_error = std::max(max_error, std::abs(output[p * 3 + c] - expected));
+        }
+    }
+    // One code of fixed-point luma and gain rounding
+    CURVE_CHECK(max_error <= 1, "%s format %d gray luminance: off by %d codes",
+                isa.name, format, max_error);
+    curve_destroy(curve);
+}
+
+// =============================================================================
+// Lab mode
+// =============================================================================
+
+/**
+ * Identity L, a and b curves take pixels to Lab and straight back
+ */
+void testLabIdentity(const IsaCase& isa, ImageFormat format, int32_t channels,
+                     double tolerance) {
+    const CurvePoint identity[] = {{0.0, 0.0}, {1.0, 1.0}};
+    CurveData* curves[3] = {};
+    const ColorChannel components[3] = {CHANNEL_LAB_L, CHANNEL_LAB_A, CHANNEL_LAB_B};
+    for (int32_t i = 0; i < 3; ++i) {
+        curve_create(identity, 2, CURVE_TYPE_LINEAR, &curves[i]);
+        curves[i]->channel = components[i];
+    }
+
+    std::vector<uint8_t> pixels = makeImage(format, channels, 23);
+    std::vector<uint8_t> result(pixels.size());
+    size_t stride = WIDTH * channels * sampleBytes(format);
+    ImageData in = {pixels.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = result.data();
+    const CurveData* stack[3] = {curves[0], curves[1], curves[2]};
+    CurveResult status = curve_apply_multi_channel(stack, 3, &in, &out, nullptr);
+    CURVE_CHECK(status == CURVE_SUCCESS, "%s: Lab apply returned %d", isa.name, status);
+
+    double difference = maxDifference(result, pixels, format);
+    CURVE_CHECK(difference <= tolerance, "%s format %d C%d Lab identity: off by %g",
+                isa.name, format, channels, difference);
+    for (CurveData* curve : curves) {
+        curve_destroy(curve);
+    }
+}
+
+/**
+ * An L curve moves gray pixels along the gray axis only
+ */
+template <typename T>
+void testLabGray(const IsaCase& isa, ImageFormat format, double tolerance) {
+    constexpr double max_code = sizeof(T) == 4 ? 1.0 : (sizeof(T) == 1 ? 255.0 : 65535.0);
+    std::vector<uint8_t> pixels(WIDTH * HEIGHT * 3 * sizeof(T));
+    auto* samples = reinterpret_cast<T*>(pixels.data());
+    for (int32_t p = 0; p < WIDTH * HEIGHT; ++p) {
+        double value = max_code * p / (WIDTH * HEIGHT - 1);
+        samples[p * 3] = samples[p * 3 + 1] = samples[p * 3 + 2] = static_cast<T>(value);
+    }
+
+    CurveData* curve = createTestCurve();
+    curve->channel = CHANNEL_LAB_L;
+    std::vector<uint8_t> result = applyCurve(*curve, pixels, format, 3);
+    const auto* output = reinterpret_cast<const T*>(result.data());
+
+    double spread = 0.0;
+    for (int32_t p = 0; p < WIDTH * HEIGHT; ++p) {
+        const T* rgb = output + p * 3;
+        spread = std::max(spread, static_cast<double>(std::max({rgb[0], rgb[1], rgb[2]})) -
+                                      std::min({rgb[0], rgb[1], rgb[2]}));
+    }
+    CURVE_CHECK(spread <= tolerance, "%s format %d Lab L on gray: channels spread by %g",
+                isa.name, format, spread);
+    curve_destroy(curve);
+}
+
+/**
+ * Vector kernels against the generic ones on the same noise image
+ */
+void testAgainstGeneric(const std::vector<IsaCase>& levels, ColorChannel channel,
+                        ImageFormat format, int32_t channels, double tolerance) {
+    CurveData* curve = createTestCurve();
+    curve->channel = channel;
+    std::vector<uint8_t> pixels = makeImage(format, channels, 17 + format);
+
+    curve_set_isa_level(CURVE_ISA_GENERIC);
+    std::vector<uint8_t> reference = applyCurve(*curve, pixels, format, channels);
+    for (const IsaCase& isa : levels) {
+        curve_set_isa_level(isa.level);
+        double difference = maxDifference(applyCurve(*curve, pixels, format, channels),
+                                          reference, format);
+        CURVE_CHECK(difference <= tolerance, "%s format %d C%d channel %d: %g from generic",
+                    isa.name, format, channels, channel, difference);
+    }
+    curve_destroy(curve);
+}
+
+} // namespace
+
+int main() {
+    if (curve_initialize() != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_initialize failed\n");
+        return 1;
+    }
+
+    std::vector<IsaCase> levels = supportedIsaLevels();
+    for (const IsaCase& isa : levels) {
+        curve_set_isa_level(isa.level);
+        testLuminanceFloat(isa, 3);
+        testLuminanceFloat(isa, 4);
+        testLuminanceGray<uint8_t>(isa, FORMAT_RGB8);
+        testLuminanceGray<uint16_t>(isa, FORMAT_RGB16);
+
+        testLabIdentity(isa, FORMAT_RGB8, 3, 1);
+        testLabIdentity(isa, FORMAT_RGBA8, 4, 1);
+        testLabIdentity(isa, FORMAT_RGB16, 3, 1);
+        testLabIdentity(isa, FORMAT_RGBA16, 4, 1);
+        testLabIdentity(isa, FORMAT_RGB32F, 3, 1e-4);
+        testLabIdentity(isa, FORMAT_RGBA32F, 4, 1e-4);
+        testLabGray<uint8_t>(isa, FORMAT_RGB8, 1);
+        testLabGray<uint16_t>(isa, FORMAT_RGB16, 1);
+        testLabGray<float>(isa, FORMAT_RGB32F, 1e-5);
+    }
+
+    for (int32_t channels : {3, 4}) {
+        bool alpha = channels == 4;
+        testAgainstGeneric(levels, CHANNEL_LUMINANCE, alpha ? FORMAT_RGBA8 : FORMAT_RGB8,
+                           channels, 0);
+        testAgainstGeneric(levels, CHANNEL_LUMINANCE, alpha ? FORMAT_RGBA16 : FORMAT_RGB16,
+                           channels, 1);
+        testAgainstGeneric(levels, CHANNEL_LUMINANCE, alpha ? FORMAT_RGBA32F : FORMAT_RGB32F,
+                           channels, 1e-5);
+
+        for (ColorChannel channel : {CHANNEL_LAB_L, CHANNEL_LAB_A, CHANNEL_LAB_B}) {
+            testAgainstGeneric(levels, channel, alpha ? FORMAT_RGBA8 : FORMAT_RGB8, channels, 1);
+            // FMA contraction in the AVX2/AVX-512 builds moves 16-bit results
+            // by up to two codes
+            testAgainstGeneric(levels, channel, alpha ? FORMAT_RGBA16 : FORMAT_RGB16,
+                               channels, 2);
+            testAgainstGeneric(levels, channel, alpha ? FORMAT_RGBA32F : FORMAT_RGB32F,
+                               channels, 1e-4);
+        }
+    }
+
+    curve_cleanup();
+    return failureCount();
+}
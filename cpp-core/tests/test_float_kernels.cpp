@@ -0,0 +1,117 @@
+/*
+ * Float kernel tests
+ * RGB32F/RGBA32F curves at every supported ISA level against the
+ * engine's double-precision master LUT, on padded rows and in place.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace CurveTests;
+
+namespace {
+
+// Kernels interpolate a float copy of the master LUT
+constexpr double TOLERANCE = 1e-5;
+
+constexpr int32_t WIDTH = 101;   // Odd, so vector loops have a tail
+constexpr int32_t HEIGHT = 13;
+constexpr size_t ROW_PADDING = 12;
+
+void testFloatCurve(const IsaCase& isa, int32_t channels, ColorChannel channel) {
+    ImageFormat format = channels == 4 ? FORMAT_RGBA32F : FORMAT_RGB32F;
+    size_t stride = WIDTH * channels * sizeof(float) + ROW_PADDING;
+    std::vector<uint8_t> input(stride * HEIGHT);
+    std::vector<uint8_t> output(stride * HEIGHT);
+
+    // Samples over [-0.2, 1.3] exercise clamping to the curve domain
+    std::vector<uint8_t> noise(WIDTH * channels * HEIGHT * 2);
+    fillNoise(noise, 7 + channels);
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        for (int32_t i = 0; i < WIDTH * channels; ++i) {
+            size_t n = (static_cast<size_t>(y) * WIDTH * channels + i) * 2;
+            float unit = (noise[n] | (noise[n + 1] << 8)) / 65535.0f;
+            row<float>(input, stride, y)[i] = -0.2f + 1.5f * unit;
+        }
+    }
+    row<float>(input, stride, 0)[0] = std::numeric_limits<float>::quiet_NaN();
+    row<float>(input, stride, 1)[0] = 0.0f;
+    row<float>(input, stride, 1)[1] = 1.0f;
+
+    CurveData* curve = createTestCurve();
+    curve->channel = channel;
+    MasterLUT master(*curve);
+    CURVE_CHECK(master.valid(), "%s: no master LUT", isa.name);
+
+    ImageData in = {input.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = output.data();
+    CurveResult result = curve_apply_to_image(curve, &in, &out, nullptr);
+    CURVE_CHECK(result == CURVE_SUCCESS, "%s: apply returned %d", isa.name, result);
+
+    double max_error = 0.0;
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        const float* source = row<float>(input, stride, y);
+        const float* target = row<float>(output, stride, y);
+        for (int32_t i = 0; i < WIDTH * channels; ++i) {
+            int32_t c = i % channels;
+            bool curved = channel == CHANNEL_RGB ? c < 3 : c == channel - CHANNEL_RED;
+            if (!curved) {
+                CURVE_CHECK(std::memcmp(&source[i], &target[i], sizeof(float)) == 0,
+                            "%s C%d ch%d: uncurved sample %d,%d changed",
+                            isa.name, channels, channel, i, y);
+                continue;
+            }
+            // NaN has no position on the curve and maps like 0
+            double x = std::isnan(source[i]) ? 0.0 : source[i];
+            max_error = std::max(max_error, std::fabs(master.sample(x) - target[i]));
+        }
+    }
+    CURVE_CHECK(max_error <= TOLERANCE, "%s C%d ch%d: max error %g",
+                isa.name, channels, channel, max_error);
+
+    // In place gives the same samples, padding included
+    std::vector<uint8_t> in_place = input;
+    ImageData buffer = {in_place.data(), WIDTH, HEIGHT, channels, format, stride};
+    ProcessingOptions options = {};
+    options.in_place = true;
+    result = curve_apply_to_image(curve, &buffer, nullptr, &options);
+    CURVE_CHECK(result == CURVE_SUCCESS, "%s: in-place apply returned %d", isa.name, result);
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        size_t row_bytes = WIDTH * channels * sizeof(float);
+        CURVE_CHECK(std::memcmp(in_place.data() + stride * y, output.data() + stride * y,
+                                row_bytes) == 0,
+                    "%s C%d ch%d: in-place row %d differs", isa.name, channels, channel, y);
+        CURVE_CHECK(std::memcmp(in_place.data() + stride * y + row_bytes,
+                                input.data() + stride * y + row_bytes, ROW_PADDING) == 0,
+                    "%s C%d ch%d: padding of row %d written", isa.name, channels, channel, y);
+    }
+
+    curve_destroy(curve);
+}
+
+} // namespace
+
+int main() {
+    if (curve_initialize() != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_initialize failed\n");
+        return 1;
+    }
+
+    for (const IsaCase& isa : supportedIsaLevels()) {
+        curve_set_isa_level(isa.level);
+        for (int32_t channels : {3, 4}) {
+            for (ColorChannel channel : {CHANNEL_RGB, CHANNEL_RED, CHANNEL_GREEN, CHANNEL_BLUE}) {
+                testFloatCurve(isa, channels, channel);
+            }
+        }
+    }
+
+    curve_cleanup();
+    return failureCount();
+}
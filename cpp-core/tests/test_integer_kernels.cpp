@@ -0,0 +1,199 @@
+/*
+ * Integer kernel tests
+ * 8 and 16-bit curves at every supported ISA level against the engine's
+ * master LUT sampled at each code, for every channel layout and for
+ * several curved-channel masks, plus the buffer checks in front of them.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "TestSupport.h"
+
+#include <cstring>
+
+using namespace CurveTests;
+
+namespace {
+
+constexpr int32_t WIDTH = 333;   // Odd, so vector loops have a tail
+constexpr int32_t HEIGHT = 17;
+constexpr size_t ROW_PADDING = 16;
+
+bool isCurved(ColorChannel channel, int32_t c) {
+    return channel == CHANNEL_RGB ? c < 3 : c == channel - CHANNEL_RED;
+}
+
+/**
+ * One curve over a padded image; integer outputs must match exactly
+ */
+template <typename T>
+void testIntegerCurve(const IsaCase& isa, ImageFormat format, int32_t channels,
+                      ColorChannel channel) {
+    constexpr int32_t max_code = sizeof(T) == 1 ? 255 : 65535;
+    size_t stride = WIDTH * channels * sizeof(T) + ROW_PADDING;
+    std::vector<uint8_t> input(stride * HEIGHT);
+    std::vector<uint8_t> output(stride * HEIGHT);
+    fillNoise(input, 11 + channels * 4 + channel);
+
+    CurveData* curve = createTestCurve();
+    curve->channel = channel;
+    MasterLUT master(*curve);
+
+    ImageData in = {input.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = output.data();
+    CurveResult result = curve_apply_to_image(curve, &in, &out, nullptr);
+    CURVE_CHECK(result == CURVE_SUCCESS, "%s: apply returned %d", isa.name, result);
+
+    int32_t mismatches = 0;
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        const T* source = row<T>(input, stride, y);
+        const T* target = row<T>(output, stride, y);
+        for (int32_t i = 0; i < WIDTH * channels; ++i) {
+            int32_t expected = isCurved(channel, i % channels)
+                                   ? master.sampleCode(source[i], max_code)
+                                   : source[i];
+            mismatches += target[i] != expected;
+        }
+    }
+    CURVE_CHECK(mismatches == 0, "%s format %d C%d ch%d: %d samples differ",
+                isa.name, format, channels, channel, mismatches);
+
+    // In place gives the same samples and leaves row padding alone
+    std::vector<uint8_t> in_place = input;
+    ImageData buffer = {in_place.data(), WIDTH, HEIGHT, channels, format, stride};
+    ProcessingOptions options = {};
+    options.in_place = true;
+    result = curve_apply_to_image(curve, &buffer, nullptr, &options);
+    CURVE_CHECK(result == CURVE_SUCCESS, "%s: in-place apply returned %d", isa.name, result);
+    size_t row_bytes = WIDTH * channels * sizeof(T);
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        CURVE_CHECK(std::memcmp(in_place.data() + stride * y, output.data() + stride * y,
+                                row_bytes) == 0,
+                    "%s format %d C%d ch%d: in-place row %d differs",
+                    isa.name, format, channels, channel, y);
+        CURVE_CHECK(std::memcmp(in_place.data() + stride * y + row_bytes,
+                                input.data() + stride * y + row_bytes, ROW_PADDING) == 0,
+                    "%s format %d C%d ch%d: padding of row %d written",
+                    isa.name, format, channels, channel, y);
+    }
+
+    curve_destroy(curve);
+}
+
+/**
+ * Separate red and blue curves in one pass: the kernel for that channel
+ * mask must leave green and alpha alone
+ */
+template <typename T>
+void testChannelMask(const IsaCase& isa, ImageFormat format, int32_t channels) {
+    constexpr int32_t max_code = sizeof(T) == 1 ? 255 : 65535;
+    size_t stride = WIDTH * channels * sizeof(T);
+    std::vector<uint8_t> input(stride * HEIGHT);
+    std::vector<uint8_t> output(stride * HEIGHT);
+    fillNoise(input, 5 + channels);
+
+    CurveData* red = createTestCurve(CURVE_TYPE_CUBIC_SPLINE);
+    CurveData* blue = createTestCurve(CURVE_TYPE_LINEAR);
+    red->channel = CHANNEL_RED;
+    blue->channel = CHANNEL_BLUE;
+    MasterLUT red_master(*red);
+    MasterLUT blue_master(*blue);
+
+    ImageData in = {input.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = output.data();
+    const CurveData* curves[] = {red, blue};
+    CurveResult result = curve_apply_multi_channel(curves, 2, &in, &out, nullptr);
+    CURVE_CHECK(result == CURVE_SUCCESS, "%s: multi-channel apply returned %d", isa.name, result);
+
+    int32_t mismatches = 0;
+    for (int32_t y = 0; y < HEIGHT; ++y) {
+        const T* source = row<T>(input, stride, y);
+        const T* target = row<T>(output, stride, y);
+        for (int32_t i = 0; i < WIDTH * channels; ++i) {
+            int32_t c = i % channels;
+            int32_t expected = c == 0   ? red_master.sampleCode(source[i], max_code)
+                               : c == 2 ? blue_master.sampleCode(source[i], max_code)
+                                        : source[i];
+            mismatches += target[i] != expected;
+        }
+    }
+    CURVE_CHECK(mismatches == 0, "%s format %d C%d red+blue: %d samples differ",
+                isa.name, format, channels, mismatches);
+
+    curve_destroy(red);
+    curve_destroy(blue);
+}
+
+/**
+ * Buffers the kernels cannot address are rejected, not reinterpreted
+ */
+void testRejectedBuffers() {
+    CurveData* curve = createTestCurve();
+    std::vector<uint8_t> input(4096);
+    std::vector<uint8_t> output(4096);
+
+    for (int32_t channels : {0, 5, 8}) {
+        ImageData in = {input.data(), 8, 8, channels, FORMAT_RGBA8, 64};
+        ImageData out = in;
+        out.data = output.data();
+        CurveResult result = curve_apply_to_image(curve, &in, &out, nullptr);
+        CURVE_CHECK(result == CURVE_ERROR_INVALID_PARAMS,
+                    "%d channels: apply returned %d", channels, result);
+    }
+
+    // Rows of 8 RGB pixels take 24 bytes
+    ImageData in = {input.data(), 8, 8, 3, FORMAT_RGB8, 20};
+    ImageData out = {output.data(), 8, 8, 3, FORMAT_RGB8, 24};
+    CurveResult result = curve_apply_to_image(curve, &in, &out, nullptr);
+    CURVE_CHECK(result == CURVE_ERROR_INVALID_PARAMS, "short input stride: %d", result);
+
+    in.stride = 24;
+    out.stride = 20;
+    result = curve_apply_to_image(curve, &in, &out, nullptr);
+    CURVE_CHECK(result == CURVE_ERROR_INVALID_PARAMS, "short output stride: %d", result);
+
+    in.stride = 20;
+    ProcessingOptions options = {};
+    options.in_place = true;
+    result = curve_apply_to_image(curve, &in, nullptr, &options);
+    CURVE_CHECK(result == CURVE_ERROR_INVALID_PARAMS, "short in-place stride: %d", result);
+
+    curve_destroy(curve);
+}
+
+} // namespace
+
+int main() {
+    if (curve_initialize() != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_initialize failed\n");
+        return 1;
+    }
+
+    const ColorChannel channels[] = {CHANNEL_RGB, CHANNEL_RED, CHANNEL_GREEN, CHANNEL_BLUE};
+    for (const IsaCase& isa : supportedIsaLevels()) {
+        curve_set_isa_level(isa.level);
+        for (ColorChannel channel : channels) {
+            testIntegerCurve<uint8_t>(isa, FORMAT_RGB8, 3, channel);
+            testIntegerCurve<uint8_t>(isa, FORMAT_RGBA8, 4, channel);
+            testIntegerCurve<uint16_t>(isa, FORMAT_RGB16, 3, channel);
+            testIntegerCurve<uint16_t>(isa, FORMAT_RGBA16, 4, channel);
+
+            // Gray and gray+alpha buffers take the runtime-channel kernels
+            testIntegerCurve<uint8_t>(isa, FORMAT_RGB8, 1, channel);
+            testIntegerCurve<uint8_t>(isa, FORMAT_RGBA8, 2, channel);
+            testIntegerCurve<uint16_t>(isa, FORMAT_RGB16, 1, channel);
+            testIntegerCurve<uint16_t>(isa, FORMAT_RGBA16, 2, channel);
+        }
+        testChannelMask<uint8_t>(isa, FORMAT_RGB8, 3);
+        testChannelMask<uint8_t>(isa, FORMAT_RGBA8, 4);
+        testChannelMask<uint16_t>(isa, FORMAT_RGB16, 3);
+        testChannelMask<uint16_t>(isa, FORMAT_RGBA16, 4);
+    }
+
+    testRejectedBuffers();
+
+    curve_cleanup();
+    return failureCount();
+}
@@ -0,0 +1,135 @@
+/*
+ * 3D LUT tests
+ * Baked LUTs applied by tetrahedral interpolation at every supported ISA
+ * level: the identity LUT, a curve baked into a LUT against applying the
+ * curve directly, and every level against the generic kernels.
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "TestSupport.h"
+
+using namespace CurveTests;
+
+namespace {
+
+constexpr int32_t WIDTH = 97;    // Odd, so vector loops have a tail
+constexpr int32_t HEIGHT = 11;
+constexpr int32_t GRID_SIZE = 33;
+
+CurveLUT3D* bakeLUT(const CurveData* curve) {
+    Lut3DOp op = {};
+    op.type = LUT3D_OP_CURVE;
+    op.curve = curve;
+    CurveLUT3D* lut = nullptr;
+    CurveResult result = curve_lut3d_bake(&op, curve ? 1 : 0, GRID_SIZE, nullptr, &lut);
+    CURVE_CHECK(result == CURVE_SUCCESS, "bake returned %d", result);
+    return lut;
+}
+
+std::vector<uint8_t> applyLUT(const CurveLUT3D* lut, std::vector<uint8_t>& pixels,
+                              ImageFormat format, int32_t channels) {
+    std::vector<uint8_t> result(pixels.size());
+    size_t stride = WIDTH * channels * sampleBytes(format);
+    ImageData in = {pixels.data(), WIDTH, HEIGHT, channels, format, stride};
+    ImageData out = in;
+    out.data = result.data();
+    CurveResult status = curve_apply_3dlut(lut, &in, &out, nullptr);
+    CURVE_CHECK(status == CURVE_SUCCESS, "format %d: 3D LUT apply returned %d", format, status);
+    return result;
+}
+
+/**
+ * Run the LUT and a reference over one noise image per format
+ * The reference is the input itself for the identity LUT and the curve
+ * applied directly otherwise; tolerances are per format in codes (1.0
+ * for float).
+ */
+void testLUT(const IsaCase& isa, const CurveData* curve, const double tolerance[3],
+             const char* label) {
+    CurveLUT3D* lut = bakeLUT(curve);
+    if (!lut) {
+        return;
+    }
+
+    const ImageFormat formats[] = {FORMAT_RGB8, FORMAT_RGBA8, FORMAT_RGB16,
+                                   FORMAT_RGBA16, FORMAT_RGB32F, FORMAT_RGBA32F};
+    for (ImageFormat format : formats) {
+        int32_t channels = format % 2 ? 4 : 3;
+        std::vector<uint8_t> pixels =
+            noiseSamples(format, static_cast<size_t>(WIDTH) * HEIGHT * channels, 29 + format);
+        std::vector<uint8_t> result = applyLUT(lut, pixels, format, channels);
+
+        std::vector<uint8_t> reference = pixels;
+        if (curve) {
+            size_t stride = WIDTH * channels * sampleBytes(format);
+            ImageData in = {pixels.data(), WIDTH, HEIGHT, channels, format, stride};
+            ImageData out = in;
+            out.data = reference.data();
+            curve_apply_to_image(curve, &in, &out, nullptr);
+        }
+
+        double difference = maxDifference(result, reference, format);
+        CURVE_CHECK(difference <= tolerance[format / 2], "%s format %d %s: off by %g",
+                    isa.name, format, label, difference);
+    }
+    curve_lut3d_destroy(lut);
+}
+
+/**
+ * Vector kernels against the generic ones on the same noise image
+ */
+void testAgainstGeneric(const std::vector<IsaCase>& levels, ImageFormat format,
+                        double tolerance) {
+    CurveData* curve = createTestCurve();
+    CurveLUT3D* lut = bakeLUT(curve);
+    int32_t channels = format % 2 ? 4 : 3;
+    std::vector<uint8_t> pixels =
+        noiseSamples(format, static_cast<size_t>(WIDTH) * HEIGHT * channels, 31 + format);
+
+    curve_set_isa_level(CURVE_ISA_GENERIC);
+    std::vector<uint8_t> reference = applyLUT(lut, pixels, format, channels);
+    for (const IsaCase& isa : levels) {
+        curve_set_isa_level(isa.level);
+        double difference = maxDifference(applyLUT(lut, pixels, format, channels),
+                                          reference, format);
+        CURVE_CHECK(difference <= tolerance, "%s format %d: %g from generic",
+                    isa.name, format, difference);
+    }
+
+    curve_lut3d_destroy(lut);
+    curve_destroy(curve);
+}
+
+} // namespace
+
+int main() {
+    if (curve_initialize() != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_initialize failed\n");
+        return 1;
+    }
+
+    // Identity nodes sit on 16-bit codes, so they return inputs to within
+    // rounding; a curve adds the error of interpolating it between nodes
+    const double identity_tolerance[3] = {1, 1, 1e-5};
+    const double curve_tolerance[3] = {1, 64, 1e-3};
+
+    std::vector<IsaCase> levels = supportedIsaLevels();
+    CurveData* curve = createTestCurve();
+    for (const IsaCase& isa : levels) {
+        curve_set_isa_level(isa.level);
+        testLUT(isa, nullptr, identity_tolerance, "identity");
+        testLUT(isa, curve, curve_tolerance, "curve");
+    }
+    curve_destroy(curve);
+
+    testAgainstGeneric(levels, FORMAT_RGB8, 1);
+    testAgainstGeneric(levels, FORMAT_RGBA8, 1);
+    testAgainstGeneric(levels, FORMAT_RGB16, 1);
+    testAgainstGeneric(levels, FORMAT_RGBA16, 1);
+    testAgainstGeneric(levels, FORMAT_RGB32F, 1e-5);
+    testAgainstGeneric(levels, FORMAT_RGBA32F, 1e-5);
+
+    curve_cleanup();
+    return failureCount();
+}
@@ -0,0 +1,364 @@
+/*
+ * curve_bench - Curve apply throughput and L1 behaviour per format
+ * Applies one curve to synthetic RGB images in every sample format and
+ * compares the engine's format-sized tables (256 x u8, 65536 x u16,
+ * float) against a reference loop over the curve's double-precision
+ * master LUT, the one table every format would share otherwise. Runs
+ * single-threaded so the counters see every lookup. L1D read misses come
+ * from perf_event on Linux; elsewhere, or where the kernel exposes no
+ * hardware counters, only timings are printed.
+ *
+ * Usage:
+ *   curve_bench [options]
+ *
+ *   --size W H         Image size (default 2000 1000)
+ *   --iterations N     Timed runs per case, best is reported (default 7)
+ *   --point X,Y        Control point in [0, 1] (repeat; default S-curve)
+ *   --type NAME        linear | spline | bezier | parametric (default spline)
+ *   --lut-size N       Master LUT resolution (default DEFAULT_LUT_SIZE)
+ *   --gradient         Smooth ramp input instead of uniform noise
+ *   --isa NAME         generic | sse42 | avx2 | avx512
+ *
+ * Copyright (c) 2024 PhotoStudio Pro
+ */
+
+#include "AdvancedCurveProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct NamedValue {
+    const char* name;
+    int value;
+};
+
+const NamedValue CURVE_TYPES[] = {
+    {"linear", CURVE_TYPE_LINEAR},
+    {"spline", CURVE_TYPE_CUBIC_SPLINE},
+    {"bezier", CURVE_TYPE_BEZIER},
+    {"parametric", CURVE_TYPE_PARAMETRIC},
+};
+
+const NamedValue ISA_LEVELS[] = {
+    {"generic", CURVE_ISA_GENERIC},
+    {"sse42", CURVE_ISA_SSE42},
+    {"avx2", CURVE_ISA_AVX2},
+    {"avx512", CURVE_ISA_AVX512},
+};
+
+template <size_t N>
+bool lookupName(const NamedValue (&table)[N], const char* name, int* value) {
+    for (const NamedValue& entry : table) {
+        if (std::strcmp(entry.name, name) == 0) {
+            *value = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+int usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [--size W H] [--iterations N] [--point X,Y]... [--type NAME]\n"
+                 "       [--lut-size N] [--gradient] [--isa NAME]\n",
+                 program);
+    return 2;
+}
+
+/**
+ * L1D read-miss counter for the calling thread
+ */
+class L1MissCounter {
+public:
+    L1MissCounter() {
+        #if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        #endif
+    }
+
+    ~L1MissCounter() {
+        #if defined(__linux__)
+        if (fd_ >= 0) close(fd_);
+        #endif
+    }
+
+    L1MissCounter(const L1MissCounter&) = delete;
+    L1MissCounter& operator=(const L1MissCounter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+        #if defined(__linux__)
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        #endif
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+        #if defined(__linux__)
+        if (fd_ < 0) return 0;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+            count = 0;
+        }
+        #endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+struct Measurement {
+    double ms = 0.0;
+    uint64_t misses = 0;
+};
+
+/**
+ * Best of several runs; the miss count is taken from the fastest one
+ */
+template <typename Fn>
+Measurement measure(int iterations, L1MissCounter& counter, Fn&& run) {
+    Measurement best;
+    best.ms = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        counter.start();
+        run();
+        uint64_t misses = counter.stop();
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        if (ms < best.ms) {
+            best.ms = ms;
+            best.misses = misses;
+        }
+    }
+    return best;
+}
+
+/**
+ * What a format-agnostic engine does per sample: normalize, interpolate
+ * the double master, convert back
+ */
+template <typename T>
+void applyMaster(const std::vector<double>& master, double max_value,
+                 const T* src, T* dst, size_t samples) {
+    const double scale = static_cast<double>(master.size() - 1);
+    const int last = static_cast<int>(master.size()) - 1;
+    for (size_t i = 0; i < samples; ++i) {
+        double pos = std::clamp(static_cast<double>(src[i]) / max_value, 0.0, 1.0) * scale;
+        int index = std::min(static_cast<int>(pos), last - 1);
+        double frac = pos - index;
+        double value = master[index] + frac * (master[index + 1] - master[index]);
+        if constexpr (sizeof(T) < sizeof(float)) {
+            dst[i] = static_cast<T>(std::clamp(value * max_value + 0.5, 0.0, max_value));
+        } else {
+            dst[i] = static_cast<T>(value);
+        }
+    }
+}
+
+template <typename T>
+void fillInput(std::vector<T>& samples, double max_value, int32_t width, bool gradient) {
+    uint32_t state = 1;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        double unit;
+        if (gradient) {
+            unit = static_cast<double>((i / 3) % width) / (width - 1);
+        } else {
+            state = state * 1664525u + 1013904223u;
+            unit = (state >> 8) / 16777215.0;
+        }
+        if constexpr (sizeof(T) < sizeof(float)) {
+            samples[i] = static_cast<T>(unit * max_value + 0.5);
+        } else {
+            samples[i] = static_cast<T>(unit);
+        }
+    }
+}
+
+struct FormatCase {
+    const char* name;
+    ImageFormat format;
+    const char* table;
+};
+
+void printRow(const char* format, const std::string& table, const Measurement& m,
+              int64_t pixels, bool counted) {
+    std::printf("%-8s %-16s %9.2f %9.1f", format, table.c_str(), m.ms,
+                pixels / (m.ms * 1000.0));
+    if (counted) {
+        std::printf(" %12.3f", static_cast<double>(m.misses) / pixels);
+    }
+    std::printf("\n");
+}
+
+template <typename T>
+void runFormat(const FormatCase& format_case, double max_value, const CurveData* curve,
+               const std::vector<double>& master, int32_t width, int32_t height,
+               int iterations, bool gradient, L1MissCounter& counter) {
+    size_t samples = static_cast<size_t>(width) * height * 3;
+    std::vector<T> input(samples);
+    std::vector<T> output(samples);
+    fillInput(input, max_value, width, gradient);
+
+    size_t stride = static_cast<size_t>(width) * 3 * sizeof(T);
+    ImageData in = {input.data(), width, height, 3, format_case.format, stride};
+    ImageData out = {output.data(), width, height, 3, format_case.format, stride};
+    ProcessingOptions options = {};
+    options.quality = 1.0;
+    options.thread_count = 1;
+
+    // Warm the curve cache so the timed runs see only the lookups
+    curve_apply_to_image(curve, &in, &out, &options);
+
+    int64_t pixels = static_cast<int64_t>(width) * height;
+    std::string engine_table = format_case.format == FORMAT_RGB32F
+        ? std::to_string(master.size()) + " x f32"
+        : format_case.table;
+    Measurement engine = measure(iterations, counter, [&] {
+        curve_apply_to_image(curve, &in, &out, &options);
+    });
+    printRow(format_case.name, engine_table, engine, pixels, counter.available());
+
+    Measurement reference = measure(iterations, counter, [&] {
+        applyMaster(master, max_value, input.data(), output.data(), samples);
+    });
+    printRow(format_case.name, std::to_string(master.size()) + " x f64", reference, pixels,
+             counter.available());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<CurvePoint> points;
+    int type = CURVE_TYPE_CUBIC_SPLINE;
+    int isa = CURVE_ISA_AUTO;
+    int32_t width = 2000;
+    int32_t height = 1000;
+    int32_t lut_size = DEFAULT_LUT_SIZE;
+    int iterations = 7;
+    bool gradient = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--size" && i + 2 < argc) {
+            width = std::atoi(argv[++i]);
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--iterations" && has_value) {
+            iterations = std::atoi(argv[++i]);
+        } else if (arg == "--point" && has_value) {
+            CurvePoint point;
+            if (std::sscanf(argv[++i], "%lf,%lf", &point.x, &point.y) != 2) {
+                return usage(argv[0]);
+            }
+            points.push_back(point);
+        } else if (arg == "--type" && has_value) {
+            if (!lookupName(CURVE_TYPES, argv[++i], &type)) return usage(argv[0]);
+        } else if (arg == "--lut-size" && has_value) {
+            lut_size = std::atoi(argv[++i]);
+        } else if (arg == "--gradient") {
+            gradient = true;
+        } else if (arg == "--isa" && has_value) {
+            if (!lookupName(ISA_LEVELS, argv[++i], &isa)) return usage(argv[0]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    if (width < 2 || height < 1 || iterations < 1 || lut_size < 2) {
+        return usage(argv[0]);
+    }
+
+    if (points.empty()) {
+        points = {{0.0, 0.0}, {0.25, 0.18}, {0.75, 0.86}, {1.0, 1.0}};
+    }
+
+    if (curve_initialize() != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_bench: engine initialization failed\n");
+        return 1;
+    }
+
+    if (isa != CURVE_ISA_AUTO &&
+        curve_set_isa_level(static_cast<CurveIsaLevel>(isa)) != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_bench: requested ISA level is not supported here\n");
+        curve_cleanup();
+        return 1;
+    }
+
+    CurveData* curve = nullptr;
+    CurveResult result = curve_create(points.data(), static_cast<int32_t>(points.size()),
+                                      static_cast<CurveType>(type), &curve);
+    double* master_data = nullptr;
+    int32_t master_size = 0;
+    if (result == CURVE_SUCCESS) {
+        curve->lut_size = lut_size;
+        result = curve_generate_lut(curve, &master_data, &master_size);
+    }
+    if (result != CURVE_SUCCESS) {
+        std::fprintf(stderr, "curve_bench: failed with error %d\n", static_cast<int>(result));
+        curve_destroy(curve);
+        curve_cleanup();
+        return 1;
+    }
+    std::vector<double> master(master_data, master_data + master_size);
+    delete[] master_data;
+
+    const char* isa_name = "unknown";
+    for (const NamedValue& entry : ISA_LEVELS) {
+        if (entry.value == curve_get_isa_level()) isa_name = entry.name;
+    }
+
+    L1MissCounter counter;
+    std::printf("%dx%d RGB, %s input, %s kernels, best of %d\n", width, height,
+                gradient ? "gradient" : "noise", isa_name, iterations);
+    std::printf("%-8s %-16s %9s %9s%s\n", "format", "table", "ms", "Mpx/s",
+                counter.available() ? "  L1D miss/px" : "");
+
+    const FormatCase rgb8 = {"rgb8", FORMAT_RGB8, "256 x u8"};
+    const FormatCase rgb16 = {"rgb16", FORMAT_RGB16, "65536 x u16"};
+    const FormatCase rgb32f = {"rgb32f", FORMAT_RGB32F, nullptr};
+    runFormat<uint8_t>(rgb8, 255.0, curve, master, width, height, iterations, gradient,
+                       counter);
+    runFormat<uint16_t>(rgb16, 65535.0, curve, master, width, height, iterations, gradient,
+                        counter);
+    runFormat<float>(rgb32f, 1.0, curve, master, width, height, iterations, gradient,
+                     counter);
+
+    if (!counter.available()) {
+        std::printf("(L1D miss counters unavailable on this system)\n");
+    }
+
+    curve_destroy(curve);
+    curve_cleanup();
+    return 0;
+}
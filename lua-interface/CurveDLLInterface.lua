@@ -35,7 +35,9 @@ ffi.cdef[[
         CURVE_ERROR_NOT_INITIALIZED = -3,
         CURVE_ERROR_GPU_NOT_AVAILABLE = -4,
         CURVE_ERROR_ML_NOT_AVAILABLE = -5,
-        CURVE_ERROR_UNSUPPORTED_FORMAT = -6
+        CURVE_ERROR_UNSUPPORTED_FORMAT = -6,
+        CURVE_ERROR_NOT_SUPPORTED = -7,
+        CURVE_ERROR_FILE_IO = -8
     } CurveResult;
     
     // Curve types
@@ -69,6 +71,15 @@ ffi.cdef[[
         FORMAT_RGBA32F = 5
     } ImageFormat;
     
+    // CPU kernel levels
+    typedef enum {
+        CURVE_ISA_AUTO = 0,
+        CURVE_ISA_GENERIC = 1,
+        CURVE_ISA_SSE42 = 2,
+        CURVE_ISA_AVX2 = 3,
+        CURVE_ISA_AVX512 = 4
+    } CurveIsaLevel;
+    
     // Control point structure
     typedef struct {
         double x;
@@ -97,6 +108,25 @@ ffi.cdef[[
         size_t stride;
     } ImageData;
     
+    // Output histograms, 256 bins each
+    typedef struct {
+        uint64_t red[256];
+        uint64_t green[256];
+        uint64_t blue[256];
+        uint64_t luma[256];
+    } CurveHistogram;
+    
+    // Single-pass image statistics
+    typedef struct {
+        uint64_t luma_histogram[256];
+        uint64_t pixel_count;
+        double luma_mean;
+        double luma_variance;
+        double channel_mean[3];
+        double shadow_clipping;
+        double highlight_clipping;
+    } CurveImageStats;
+    
     // Processing options
     typedef struct {
         bool use_gpu;
@@ -104,8 +134,40 @@ ffi.cdef[[
         bool real_time;
         int32_t thread_count;
         double quality;
+        bool in_place;
+        CurveHistogram* output_histogram;
     } ProcessingOptions;
     
+    // Raster file layout
+    typedef struct {
+        ImageFormat format;
+        int32_t width;
+        int32_t height;
+        size_t data_offset;
+        size_t stride;
+        bool big_endian;
+    } RasterFileLayout;
+    
+    // Color enhancement settings
+    typedef struct {
+        float saturation_boost;
+        float vibrance;
+        float temperature;
+        float tint;
+    } ColorEnhanceParams;
+    
+    // 3D LUT bake operations
+    typedef enum {
+        LUT3D_OP_CURVE = 0,
+        LUT3D_OP_COLOR_ENHANCE = 1
+    } Lut3DOpType;
+    
+    typedef struct {
+        Lut3DOpType type;
+        const CurveData* curve;
+        ColorEnhanceParams enhance;
+    } Lut3DOp;
+    
     // AI suggestion parameters
     typedef struct {
         double contrast_boost;
@@ -131,6 +193,8 @@ ffi.cdef[[
     bool curve_is_gpu_available(void);
     bool curve_is_ai_available(void);
     int32_t curve_get_ml_operator_count(void);
+    CurveResult curve_set_isa_level(CurveIsaLevel level);
+    CurveIsaLevel curve_get_isa_level(void);
     
     // Curve processing functions
     CurveResult curve_create(const CurvePoint* points, int32_t point_count,
@@ -138,8 +202,55 @@ ffi.cdef[[
     void curve_destroy(CurveData* curve);
     CurveResult curve_apply_to_image(const CurveData* curve, const ImageData* input,
                                    ImageData* output, const ProcessingOptions* options);
+    CurveResult curve_apply_to_region(const CurveData* curve, const ImageData* input,
+                                    ImageData* output, int32_t x, int32_t y,
+                                    int32_t width, int32_t height,
+                                    const ProcessingOptions* options);
+    CurveResult curve_compose(const CurveData** curves, int32_t curve_count,
+                            CurveData** out_curve);
     CurveResult curve_generate_lut(const CurveData* curve, double** lut, int32_t* lut_size);
     
+    // Streaming processing
+    typedef struct CurveStream CurveStream;
+    CurveResult curve_stream_begin(const CurveData* curve, ImageFormat format, int32_t width,
+                                 const ProcessingOptions* options, CurveStream** out_stream);
+    CurveResult curve_stream_push_rows(CurveStream* stream, const void* input_rows,
+                                     size_t input_stride, void* output_rows,
+                                     size_t output_stride, int32_t row_count);
+    void curve_stream_end(CurveStream* stream);
+    
+    // Interactive editing
+    typedef struct CurveEditor CurveEditor;
+    CurveResult curve_editor_create(const CurveData* curve, CurveEditor** out_editor);
+    CurveResult curve_move_point(CurveEditor* editor, int32_t index, double x, double y,
+                               int32_t* out_first, int32_t* out_count);
+    const CurveData* curve_editor_get_curve(const CurveEditor* editor);
+    CurveResult curve_editor_get_lut(const CurveEditor* editor, const double** lut,
+                                   int32_t* lut_size);
+    CurveResult curve_editor_apply_to_region(const CurveEditor* editor, const ImageData* input,
+                                           ImageData* output, int32_t x, int32_t y,
+                                           int32_t width, int32_t height,
+                                           const ProcessingOptions* options);
+    void curve_editor_destroy(CurveEditor* editor);
+    
+    // File processing
+    CurveResult curve_apply_to_file(const CurveData* curve, const char* input_path,
+                                  const char* output_path, const RasterFileLayout* layout,
+                                  const ProcessingOptions* options);
+    
+    // 3D LUTs
+    typedef struct CurveLUT3D CurveLUT3D;
+    CurveResult curve_lut3d_bake(const Lut3DOp* ops, int32_t op_count, int32_t grid_size,
+                               const ProcessingOptions* options, CurveLUT3D** out_lut);
+    CurveResult curve_apply_3dlut(const CurveLUT3D* lut, const ImageData* input,
+                                ImageData* output, const ProcessingOptions* options);
+    CurveResult curve_lut3d_load_cube(const char* path, CurveLUT3D** out_lut);
+    CurveResult curve_lut3d_save_cube(const CurveLUT3D* lut, const char* path, const char* title);
+    void curve_lut3d_destroy(CurveLUT3D* lut);
+    
+    // Image analysis
+    CurveResult curve_analyze_image(const ImageData* image, CurveImageStats* stats);
+    
     // AI-powered features (183 DirectML operators)
     CurveResult curve_ai_suggest(const ImageData* image, const AISuggestionParams* params,
                                CurveData** suggested_curve);
@@ -158,6 +269,34 @@ ffi.cdef[[
     // Performance monitoring
     CurveResult curve_get_performance_stats(PerformanceStats* stats);
     void curve_enable_profiling(bool enable);
+
+    // Engine contexts
+    typedef struct CurveContext CurveContext;
+    CurveResult curve_context_create(int32_t thread_count, CurveContext** out_context);
+    void curve_context_destroy(CurveContext* context);
+    CurveResult curve_context_apply_to_image(CurveContext* context, const CurveData* curve,
+                                           const ImageData* input, ImageData* output,
+                                           const ProcessingOptions* options);
+    CurveResult curve_context_apply_to_region(CurveContext* context, const CurveData* curve,
+                                            const ImageData* input, ImageData* output,
+                                            int32_t x, int32_t y, int32_t width, int32_t height,
+                                            const ProcessingOptions* options);
+    CurveResult curve_context_apply_multi_channel(CurveContext* context, const CurveData** curves,
+                                                int32_t curve_count, const ImageData* input,
+                                                ImageData* output,
+                                                const ProcessingOptions* options);
+    CurveResult curve_context_stream_begin(CurveContext* context, const CurveData* curve,
+                                         ImageFormat format, int32_t width,
+                                         const ProcessingOptions* options,
+                                         CurveStream** out_stream);
+    CurveResult curve_context_apply_to_file(CurveContext* context, const CurveData* curve,
+                                          const char* input_path, const char* output_path,
+                                          const RasterFileLayout* layout,
+                                          const ProcessingOptions* options);
+    CurveResult curve_context_analyze_image(CurveContext* context, const ImageData* image,
+                                          CurveImageStats* stats);
+    CurveResult curve_context_get_performance_stats(CurveContext* context,
+                                                  PerformanceStats* stats);
 ]]
 
 --[[
@@ -334,6 +473,103 @@ function CurveDLLInterface.destroyCurve(curve_ptr)
     end
 end
 
+--[[
+    Compose stacked curves (e.g. film base, contrast, user curve) into one
+    Curves apply in list order; the result costs one curve per pixel and
+    must be freed with destroyCurve.
+]]
+function CurveDLLInterface.composeCurves(curve_ptrs)
+    if not CurveDLLInterface.isReady() then
+        logger:error("DLL not ready for composeCurves")
+        return nil
+    end
+    
+    if not curve_ptrs or #curve_ptrs == 0 then
+        logger:error("No curves to compose")
+        return nil
+    end
+    
+    local c_curves = ffi.new("const CurveData*[?]", #curve_ptrs)
+    for i = 1, #curve_ptrs do
+        c_curves[i-1] = curve_ptrs[i]
+    end
+    
+    local curve_ptr = ffi.new("CurveData*[1]")
+    local result = dll.curve_compose(c_curves, #curve_ptrs, curve_ptr)
+    
+    if result == 0 then  -- CURVE_SUCCESS
+        return curve_ptr[0]
+    else
+        logger:error("Failed to compose curves, error: " .. tostring(result))
+        return nil
+    end
+end
+
+--[[
+    Start editing a copy of a curve, for dragging points in the dialog
+    Free the editor with destroyEditor.
+]]
+function CurveDLLInterface.createEditor(curve_ptr)
+    if not CurveDLLInterface.isReady() then
+        logger:error("DLL not ready for createEditor")
+        return nil
+    end
+    
+    local editor_ptr = ffi.new("CurveEditor*[1]")
+    local result = dll.curve_editor_create(curve_ptr, editor_ptr)
+    
+    if result == 0 then  -- CURVE_SUCCESS
+        return editor_ptr[0]
+    else
+        logger:error("Failed to create curve editor, error: " .. tostring(result))
+        return nil
+    end
+end
+
+--[[
+    Move point `index` (1-based) of an editor's curve
+    Only the LUT entries the move affects are rewritten; returns the first
+    rewritten entry (0-based) and the entry count, which is 0 when the
+    point did not move.
+]]
+function CurveDLLInterface.movePoint(editor_ptr, index, x, y)
+    if not CurveDLLInterface.isReady() or not editor_ptr then
+        return nil
+    end
+    
+    local first = ffi.new("int32_t[1]")
+    local count = ffi.new("int32_t[1]")
+    local result = dll.curve_move_point(editor_ptr, index - 1, x, y, first, count)
+    
+    if result == 0 then
+        return first[0], count[0]
+    else
+        logger:error("Failed to move curve point, error: " .. tostring(result))
+        return nil
+    end
+end
+
+--[[
+    Current curve of an editor; owned by the editor, valid until it is
+    destroyed
+]]
+function CurveDLLInterface.getEditorCurve(editor_ptr)
+    if not dll or not editor_ptr then
+        return nil
+    end
+    
+    return dll.curve_editor_get_curve(editor_ptr)
+end
+
+--[[
+    Destroy curve editor
+]]
+function CurveDLLInterface.destroyEditor(editor_ptr)
+    if dll and editor_ptr then
+        dll.curve_editor_destroy(editor_ptr)
+    end
+end
+
 --[[
     Generate AI-suggested curve based on image analysis
     Uses DirectML operators for intelligent processing
@@ -379,6 +615,48 @@ function CurveDLLInterface.generateAISuggestion(image_data, params)
     end
 end
 
+--[[
+    Gather image statistics in one pass
+    Returns mean and variance of luma, per-channel means (normalized),
+    clipping percentages and the 256-bin luma histogram (1-based)
+]]
+function CurveDLLInterface.getImageStats(image_data)
+    if not CurveDLLInterface.isReady() then
+        return nil
+    end
+    
+    local c_image = ffi.new("ImageData")
+    c_image.data = image_data.data
+    c_image.width = image_data.width
+    c_image.height = image_data.height
+    c_image.channels = image_data.channels
+    c_image.format = image_data.format or 0
+    c_image.stride = image_data.stride or (image_data.width * image_data.channels)
+    
+    local stats = ffi.new("CurveImageStats")
+    local result = dll.curve_analyze_image(c_image, stats)
+    
+    if result ~= 0 then
+        logger:error("Failed to gather image statistics, error: " .. tostring(result))
+        return nil
+    end
+    
+    local histogram = {}
+    for i = 0, 255 do
+        histogram[i + 1] = tonumber(stats.luma_histogram[i])
+    end
+    
+    return {
+        pixel_count = tonumber(stats.pixel_count),
+        luma_mean = stats.luma_mean,
+        luma_variance = stats.luma_variance,
+        channel_mean = {stats.channel_mean[0], stats.channel_mean[1], stats.channel_mean[2]},
+        shadow_clipping = stats.shadow_clipping,
+        highlight_clipping = stats.highlight_clipping,
+        luma_histogram = histogram
+    }
+end
+
 --[[
     Analyze image characteristics using AI
     Uses DirectML operators 0-7 for comprehensive analysis